@@ -0,0 +1,120 @@
+//!
+//! @file   format_test.cpp
+//! @author Sholomov Dmitry
+//! @date   17.10.2026
+//! @brief  Tests of sx::format: the output of the matching arguments is the one of snprintf.
+//!
+
+#include <xhelpers/sx_format.h>
+#include "sx_test.h"
+
+#include <climits>
+
+using namespace std;
+using namespace sx;
+
+template <class T>
+static bool same_as_printf(const char* fmt, T x)
+{
+  char buf[512];
+  snprintf(buf, sizeof(buf), fmt, x);
+  bool ok = format(fmt, x) == buf;
+  if (!ok)
+    fprintf(stderr, "format(\"%s\") gives \"%s\", snprintf gives \"%s\"\n", fmt, format(fmt, x).c_str(), buf);
+  return ok;
+}
+
+static void test_integers()
+{
+  const char* fmts[] = { "%d", "%5d", "%-5d|", "%05d", "%+d", "% d", "%.3d", "%8.3d", "%-+8.3d|" };
+  const int vals[] = { 0, 1, -1, 42, -42, 12345678, INT_MAX, INT_MIN };
+  for (size_t f = 0; f < sizeof(fmts) / sizeof(fmts[0]); f++)
+    for (size_t v = 0; v < sizeof(vals) / sizeof(vals[0]); v++)
+      SX_CHECK(same_as_printf(fmts[f], vals[v]));
+
+  const char* ufmts[] = { "%u", "%x", "%X", "%#x", "%o", "%#o", "%08x", "%#10X" };
+  const unsigned uvals[] = { 0, 1, 8, 255, 0xDEADBEEF, UINT_MAX };
+  for (size_t f = 0; f < sizeof(ufmts) / sizeof(ufmts[0]); f++)
+    for (size_t v = 0; v < sizeof(uvals) / sizeof(uvals[0]); v++)
+      SX_CHECK(same_as_printf(ufmts[f], uvals[v]));
+
+  SX_CHECK(same_as_printf("%lld", LLONG_MIN));
+  SX_CHECK(same_as_printf("%llu", ULLONG_MAX));
+}
+
+static void test_doubles()
+{
+  const char* fmts[] = { "%f", "%.0f", "%.2f", "%10.3f", "%-10.1f|", "%+.1f", "%e", "%.3E", "%g", "%G", "%#g", "%.10g", "%a" };
+  const double vals[] = { 0.0, -0.0, 1.0, -2.5, 0.125, 3.14159265358979, 1e-7, 123456789.987, 1e300, -1e-300 };
+  for (size_t f = 0; f < sizeof(fmts) / sizeof(fmts[0]); f++)
+    for (size_t v = 0; v < sizeof(vals) / sizeof(vals[0]); v++)
+      SX_CHECK(same_as_printf(fmts[f], vals[v]));
+}
+
+static void test_strings()
+{
+  SX_CHECK(same_as_printf("%s", "text"));
+  SX_CHECK(same_as_printf("[%8s]", "text"));
+  SX_CHECK(same_as_printf("[%-8s]", "text"));
+  SX_CHECK(same_as_printf("[%.2s]", "text"));
+  SX_CHECK(same_as_printf("[%s]", ""));
+  SX_CHECK(same_as_printf("%c", 'x'));
+  SX_CHECK(same_as_printf("[%3c]", 'x'));
+  SX_CHECK(format("%s=%d", string("n"), 5) == "n=5");
+  SX_CHECK(format("%*d|%-*.*f", 5, 42, 8, 2, 3.14159) == "   42|3.14    ");
+  SX_CHECK(format("100%%") == "100%");
+}
+
+static void test_mismatch()
+{
+  // the arguments are formatted by their types
+  SX_CHECK(format("%d", 2.7) == "2");
+  SX_CHECK(format("%f", 2) == "2.000000");
+  SX_CHECK(format("%d", "str") == "str");
+  SX_CHECK(format("%d %d", 1) == "1 %d");
+  SX_CHECK(format("%q") == "%q");
+}
+
+static void test_buffer()
+{
+  char buf[8];
+  SX_CHECK(format_to(buf, sizeof(buf), "%d-%s", 12345, "abcdef") == 12);
+  SX_CHECK(string(buf) == "12345-a");
+  SX_CHECK(format_to(buf, sizeof(buf), "%s", "") == 0 && buf[0] == 0);
+  SX_CHECK(format_to(buf, sizeof(buf), "%3s|", "") == 4 && string(buf) == "   |");
+  SX_CHECK(format_to(buf, sizeof(buf), "%s|%c", str_view(), 'x') == 2 && string(buf) == "|x");
+
+  static const compiled_format fmt("%04x:%s");
+  string out = "> ";
+  format_to(out, fmt, 255u, "ff");
+  SX_CHECK(out == "> 00ff:ff");
+  SX_CHECK(format_to(buf, sizeof(buf), fmt, 1u, "") == 5 && string(buf) == "0001:");
+}
+
+#define SX_TEST_TEXT "0123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789"
+#define SX_TEST_TEXT10 SX_TEST_TEXT SX_TEST_TEXT SX_TEST_TEXT SX_TEST_TEXT SX_TEST_TEXT \
+  SX_TEST_TEXT SX_TEST_TEXT SX_TEST_TEXT SX_TEST_TEXT SX_TEST_TEXT
+
+static void test_checked()
+{
+  // the text between the specifications doesn't deepen the constexpr recursion
+  static_assert(sx::detail::format_arg_count(SX_TEST_TEXT10 "%d" SX_TEST_TEXT10 SX_TEST_TEXT10 "%5s" SX_TEST_TEXT10) == 2,
+    "format_arg_count of a long format");
+  SX_CHECK(SX_FORMAT("%d of %d", 1, 2) == "1 of 2");
+  SX_CHECK(SX_FORMAT("%% %*.*f", 6, 1, 2.25) == "%    2.2");
+  string s;
+  SX_FORMAT_TO(s, "%s%c", "a", 'b');
+  SX_CHECK(s == "ab");
+  static_assert(sx::detail::format_arg_count("a%%b%-08.3lld %*d %.*s %q %") == 5, "format_arg_count");
+}
+
+int main()
+{
+  test_integers();
+  test_doubles();
+  test_strings();
+  test_mismatch();
+  test_buffer();
+  test_checked();
+  return sx_test::result("format_test");
+}
@@ -0,0 +1,126 @@
+//!
+//! @file   memory_test.cpp
+//! @author Sholomov Dmitry
+//! @date   17.10.2026
+//! @brief  Tests of the monotonic arena, arena strings and the string pool.
+//!
+
+#include <xhelpers/sx_string.h>
+#include <xhelpers/sx_stringpool.h>
+#include "sx_test.h"
+
+#include <thread>
+
+using namespace std;
+using namespace sx;
+
+static void test_arena()
+{
+  monotonic_arena arena(1024);
+  char* a = static_cast<char*>(arena.allocate(10, 1));
+  double* d = static_cast<double*>(arena.allocate(sizeof(double), alignof(double)));
+  SX_CHECK(((size_t)d & (alignof(double) - 1)) == 0);
+  SX_CHECK((char*)d >= a + 10);
+  *d = 1.5;
+  void* big = arena.allocate(4096);           // own block, the current one is kept
+  SX_CHECK(big != NULL);
+  SX_CHECK(arena.used() == 10 + sizeof(double) + 4096);
+  arena.release();
+  SX_CHECK(arena.used() == 0);
+
+  vector<int, arena_allocator<int> > v((arena_allocator<int>(arena)));
+  for (int i = 0; i < 10000; i++)
+    v.push_back(i);
+  SX_CHECK(v.size() == 10000 && v[9999] == 9999);
+  SX_CHECK(v.get_allocator() == arena_allocator<char>(arena));
+  SX_CHECK(arena_allocator<int>() != arena_allocator<int>(arena));
+}
+
+static void test_arena_string()
+{
+  monotonic_arena arena;
+  arena_string s("hello world", arena_allocator<char>(arena));
+  SX_CHECK(s.get_allocator().get_arena() == &arena);
+  s.replace("world", "arena");
+  SX_CHECK(s == "hello arena");
+  s.format("%s %d", "a string too long for the short string buffer", 5);
+  SX_CHECK(s == "a string too long for the short string buffer 5");
+  SX_CHECK(s.get_allocator().get_arena() == &arena && arena.used() > 0);
+
+  arena_string h("heap");
+  SX_CHECK(h.get_allocator().get_arena() == NULL);
+}
+
+static void test_string_pool()
+{
+  string_pool pool;
+  pooled_string e = pool.intern("");
+  SX_CHECK(e.empty() && e.id() == 0);
+  pooled_string a = pool.intern("alpha");
+  pooled_string b = pool.intern("beta");
+  pooled_string a2 = pool.intern(string("alpha"));
+  SX_CHECK(a == a2 && a != b);
+  SX_CHECK(a.id() == 1 && b.id() == 2 && pool.size() == 3);
+  SX_CHECK(a.str() == "alpha" && pool.str(2) == str_view("beta"));
+  SX_CHECK(pool.at(a.id()) == a);
+  pooled_string f;
+  SX_CHECK(pool.find("beta", f) && f == b);
+  SX_CHECK(!pool.find("gamma", f));
+
+  vector<pooled_string> tokens;
+  SX_CHECK(split(tokens, "alpha beta alpha", " ", pool) == 3);
+  SX_CHECK(tokens[0] == a && tokens[2] == a && tokens[1] == b);
+}
+
+struct interner
+{
+  string_pool* pool;
+  int nFrom;
+  vector<unsigned>* ids;
+  void operator()() const
+  {
+    for (int i = 0; i < 20000; i++)
+    {
+      char buf[16];
+      snprintf(buf, sizeof(buf), "s%d", (i + nFrom) % 20000);
+      (*ids)[(i + nFrom) % 20000] = pool->intern(buf).id();
+    }
+  }
+};
+
+static void test_string_pool_threads()
+{
+  string_pool pool;
+  const int nThreads = 4;
+  vector<vector<unsigned> > ids(nThreads, vector<unsigned>(20000));
+  vector<thread> threads;
+  for (int t = 0; t < nThreads; t++)
+  {
+    interner in = { &pool, t * 5000, &ids[t] };
+    threads.push_back(thread(in));
+  }
+  for (size_t t = 0; t < threads.size(); t++)
+    threads[t].join();
+
+  // every string got one id, the ids are dense
+  SX_CHECK(pool.size() == 20001);
+  bool ok = true;
+  for (int t = 1; t < nThreads; t++)
+    ok = ok && ids[t] == ids[0];
+  for (int i = 0; i < 20000; i++)
+  {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "s%d", i);
+    ok = ok && ids[0][i] > 0 && ids[0][i] <= 20000 && pool.str(ids[0][i]) == str_view(buf);
+  }
+  SX_CHECK(ok);
+}
+
+int main()
+{
+  test_arena();
+  test_arena_string();
+  test_string_pool();
+  test_string_pool_threads();
+  return sx_test::result("memory_test");
+}
@@ -0,0 +1,290 @@
+//!
+//! @file   srm_test.cpp
+//! @author Sholomov Dmitry
+//! @date   17.10.2026
+//! @brief  Tests of the delimited and CSV stream reading and writing of sx_srm.h.
+//!
+
+#include <xhelpers/sx_srm.h>
+#include "sx_test.h"
+
+#include <sstream>
+#include <cstdio>
+
+using namespace std;
+using namespace sx;
+
+typedef vector<vector<string> > table;
+
+static table read_serial(const string& data, const char* delim, bool bCsv)
+{
+  istringstream is(data);
+  idelimstream ids(is.rdbuf(), delim);
+  if (bCsv)
+    ids.set_csv();
+  table tbl;
+  ids >> tbl;
+  return tbl;
+}
+
+static void test_csv_quoting()
+{
+  vector<string> row;
+  row.push_back("a");
+  row.push_back("b,c");
+  row.push_back("d\"e");
+  row.push_back("f\ng");
+  row.push_back("");
+
+  ostringstream os;
+  odelimstream ods(os.rdbuf());
+  ods.set_csv();
+  ods << row;
+  SX_CHECK(os.str() == "a,\"b,c\",\"d\"\"e\",\"f\ng\",");
+
+  table tbl(1, row);
+  tbl.push_back(vector<string>(1, "plain"));
+  ostringstream os2;
+  odelimstream ods2(os2.rdbuf());
+  ods2.set_csv();
+  ods2 << tbl;
+  SX_CHECK(read_serial(os2.str(), ",", true) == tbl);
+}
+
+static void test_csv_empty_fields()
+{
+  // a row of one empty field is not an empty line, which is read as a row without fields
+  table tbl;
+  tbl.push_back(vector<string>(1, ""));
+  tbl.push_back(vector<string>(2, ""));
+  tbl.push_back(vector<string>(1, "x"));
+  tbl.push_back(vector<string>());
+  tbl.push_back(vector<string>(1, ""));
+
+  ostringstream os;
+  odelimstream ods(os.rdbuf());
+  ods.set_csv();
+  ods << tbl;
+  SX_CHECK(os.str() == "\"\"\n,\nx\n\n\"\"\n");
+  SX_CHECK(read_serial(os.str(), ",", true) == tbl);
+
+  istringstream is(os.str());
+  idelimstream ids(is.rdbuf());
+  ids.set_csv();
+  delim_table dt;
+  ids >> dt;
+  ostringstream os2;
+  odelimstream ods2(os2.rdbuf());
+  ods2.set_csv();
+  ods2 << dt;
+  SX_CHECK(os2.str() == os.str());
+}
+
+static void test_csv_parallel()
+{
+  string data;
+  for (int i = 0; i < 2000; i++)
+  {
+    char buf[64];
+    if (i % 7 == 0)
+      snprintf(buf, sizeof(buf), "%d,\"multi\nline %d\",\"q\"\"%d\"\n", i, i, i);
+    else
+      snprintf(buf, sizeof(buf), "%d,field %d,%d\n", i, i, i * 3);
+    data += buf;
+  }
+  table serial = read_serial(data, ",", true);
+  SX_CHECK(serial.size() == 2000);
+  for (int nThreads = 1; nThreads <= 4; nThreads++)
+  {
+    table par;
+    read_csv_parallel(data.data(), data.data() + data.size(), par, csv_dialect(), '\n', nThreads);
+    SX_CHECK(par == serial);
+  }
+}
+
+static void test_table_parallel()
+{
+  string data;
+  for (int i = 0; i < 3000; i++)
+  {
+    char buf[64];
+    snprintf(buf, sizeof(buf), i % 11 ? "%d\t%d  x\t%d\n" : "\n", i, i * 2, i * 3);
+    data += buf;
+  }
+  data += "last\tline";
+  table serial = read_serial(data, "\t ", false);
+  for (int nThreads = 1; nThreads <= 4; nThreads++)
+  {
+    table par;
+    read_table_parallel(data.data(), data.data() + data.size(), par, delim_set("\t "), '\n', false, nThreads);
+    SX_CHECK(par == serial);
+  }
+
+  const char* filename = "srm_test_parallel.txt";
+  SX_CHECK(sx_test::write_file(filename, data));
+  ifdelimstream ifs(filename, "\t ");
+  table par;
+  ifs.read_parallel(par, 3);
+  SX_CHECK(par == serial);
+
+  // the stream opened after the default construction reads the same
+  ifdelimstream ifs2, ifs3;
+  ifs2.open(filename);
+  ifs3.open(string(filename));
+  table par2, serial2;
+  ifs2.read_parallel(par2, 3);
+  ifs3 >> serial2;
+  SX_CHECK(par2.size() == 3001 && par2 == serial2);
+  ifs2.close();
+  ifs3.close();
+
+  ifdelimstream ifs4;
+  ifs4.open(filename);
+  table ahead;
+  SX_CHECK(ifs4.read_ahead(1 << 12) && ifs4.is_read_ahead());
+  ifs4 >> ahead;
+  SX_CHECK(ahead == serial2);
+  ifs4.close();
+  remove(filename);
+}
+
+static void test_seek_row()
+{
+  const char* filename = "srm_test_seek.txt";
+  string data;
+  for (int i = 0; i < 500; i++)
+  {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "row%d\t%d\n", i, i);
+    data += buf;
+  }
+  SX_CHECK(sx_test::write_file(filename, data));
+
+  ifdelimstream ifs(filename, "\t");
+  SX_CHECK(ifs.row_count() == 500);
+  vector<string> row;
+  SX_CHECK(ifs.seek_row(321));
+  ifs >> row;
+  SX_CHECK(row.size() == 2 && row[0] == "row321" && row[1] == "321");
+  SX_CHECK(ifs.seek_row(0));
+  ifs >> row;
+  SX_CHECK(row.size() == 2 && row[0] == "row0");
+  SX_CHECK(!ifs.seek_row(500));
+  ifs.close();
+
+  // the saved index is loaded by the next stream
+  ifdelimstream ifs2(filename, "\t");
+  SX_CHECK(ifs2.seek_row(499));
+  ifs2 >> row;
+  SX_CHECK(row.size() == 2 && row[0] == "row499");
+  ifs2.close();
+
+  // seeking by the stream opened after the default construction
+  ifdelimstream ifs3;
+  ifs3.open(filename);
+  SX_CHECK(ifs3.row_count() == 500);
+  string line;
+  SX_CHECK(ifs3.seek_row(42) && getline(ifs3, line) && line == "row42\t42");
+  ifs3.close();
+
+  // rewriting the file with the same size right away invalidates the saved index
+  string data2 = data;
+  data2.replace(0, 7, "r\n0\n0\t\n");
+  SX_CHECK(data2.size() == data.size() && sx_test::write_file(filename, data2));
+  ifdelimstream ifs4(filename, "\t");
+  SX_CHECK(ifs4.row_count() == 502);
+  SX_CHECK(ifs4.seek_row(3) && getline(ifs4, line) && line == "row1\t1");
+  ifs4.close();
+
+  remove(filename);
+  remove((string(filename) + ".lidx").c_str());
+}
+
+struct row_counter
+{
+  size_t* pFields;
+  bool operator()(const vector<str_view>& row) const { *pFields += row.size(); return true; }
+};
+
+static void test_for_each_row()
+{
+  const char* filename = "srm_test_each.txt";
+  SX_CHECK(sx_test::write_file(filename, "a b c\nd e\n\nf"));
+  size_t nFields = 0, nRows = 0;
+  row_counter counter = { &nFields };
+  SX_CHECK(for_each_row(filename, " ", counter, nRows));
+  SX_CHECK(nRows == 4 && nFields == 6);
+  remove(filename);
+  SX_CHECK(!for_each_row(filename, " ", counter, nRows));
+
+  // the line is cut at a zero char as the stream version does
+  string data("a b\0x y\nc d\n", 12);
+  SX_CHECK(sx_test::write_file(filename, data));
+  nFields = 0;
+  SX_CHECK(for_each_row(filename, " ", counter, nRows));
+  SX_CHECK(nRows == 2 && nFields == 4);
+  istringstream is(data);
+  nFields = 0;
+  SX_CHECK(for_each_row(is, " ", counter) == 2 && nFields == 4);
+
+  {
+    mapped_delim_reader reader(filename, " ");
+    delim_table tbl;
+    reader >> tbl;
+    vector<string> row;
+    SX_CHECK(tbl.rows() == 2);
+    tbl.row(0, row);
+    SX_CHECK(row.size() == 2 && row[1] == "b");
+    tbl.row(1, row);
+    SX_CHECK(row.size() == 2 && row[1] == "d");
+  }
+  remove(filename);
+}
+
+static void test_delim_table()
+{
+  string data = "a\tbb\tccc\nd\n\te\t\n";
+  istringstream is(data);
+  idelimstream ids(is.rdbuf(), "\t");
+  delim_table tbl;
+  ids >> tbl;
+  table serial = read_serial(data, "\t", false);
+  SX_CHECK(tbl.rows() == serial.size());
+  for (size_t r = 0; r < tbl.rows() && r < serial.size(); r++)
+  {
+    vector<string> row;
+    tbl.row(r, row);
+    SX_CHECK(row == serial[r]);
+  }
+  SX_CHECK(tbl.at(0, 2) == str_view("ccc"));
+  SX_CHECK(tbl.at(1, 2).empty());
+
+  // fields copied from the table itself survive the arena growth
+  delim_table self;
+  self.add_row();
+  self.add_field("abc", "abc" + 3);
+  for (int i = 0; i < 100; i++)
+  {
+    str_view f = self.at(self.rows() - 1, 0);
+    self.add_row();
+    self.add_field(f.data(), f.data() + f.size());
+    self.push_row(vector<str_view>(1, self.at(0, 0)));
+  }
+  SX_CHECK(self.rows() == 201);
+  bool bSame = true;
+  for (size_t r = 0; r < self.rows(); r++)
+    bSame = bSame && self.at(r, 0) == str_view("abc");
+  SX_CHECK(bSame);
+}
+
+int main()
+{
+  test_csv_quoting();
+  test_csv_empty_fields();
+  test_csv_parallel();
+  test_table_parallel();
+  test_seek_row();
+  test_for_each_row();
+  test_delim_table();
+  return sx_test::result("srm_test");
+}
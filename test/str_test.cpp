@@ -0,0 +1,203 @@
+//!
+//! @file   str_test.cpp
+//! @author Sholomov Dmitry
+//! @date   17.10.2026
+//! @brief  Tests of the string helpers: search, splitting, replacing, case conversion and batches.
+//!
+
+#include <xhelpers/sx_str.h>
+#include <xhelpers/sx_utf8case.h>
+#include <xhelpers/sx_matchtemplate.h>
+#include <xhelpers/sx_batch.h>
+#include <xhelpers/sx_string.h>
+#include "sx_test.h"
+
+namespace sx { class tf_string; }                       // tf_string is a class and can be forward declared
+
+using namespace std;
+using namespace sx;
+
+static void test_multi_replacer()
+{
+  vector<pair<string, string> > dict;
+  dict.push_back(make_pair(string("a"), string("1")));
+  dict.push_back(make_pair(string("ab"), string("2")));
+  dict.push_back(make_pair(string("abc"), string("3")));
+  dict.push_back(make_pair(string("bcd"), string("4")));
+  multi_replacer mr(dict);
+
+  // the leftmost match wins, then the longest one at that position
+  string s = "abcd";
+  SX_CHECK(mr.replace(s) == 1 && s == "3d");
+  s = "xbcdab";
+  SX_CHECK(mr.replace(s) == 2 && s == "x42");
+  s = "aab";
+  SX_CHECK(mr.replace(s) == 2 && s == "12");
+  s = "zzz";
+  SX_CHECK(mr.replace(s) == 0 && s == "zzz");
+
+  // the output is not searched again
+  multi_replacer self;
+  self.add("ab", "xab");
+  s = "abab";
+  SX_CHECK(replace_many(s, self) == 2 && s == "xabxab");
+}
+
+static void test_replace()
+{
+  string s = "one two one two";
+  SX_CHECK(replace_all_once(s, "one", "1") == 2 && s == "1 two 1 two");
+  replace_first(s, "two", "2");
+  SX_CHECK(s == "1 2 1 two");
+  replace_from_end(s, "two", "2");
+  SX_CHECK(s == "1 2 1 2");
+}
+
+static void test_search()
+{
+  string s = "the quick brown fox jumps over the lazy dog";
+  SX_CHECK(sx::find(s, "the") == 0);
+  SX_CHECK(sx::find(s, "the", 1) == 31);
+  SX_CHECK(sx::rfind(s, "the") == 31);
+  SX_CHECK(sx::find(s, "cat") == str_view::npos);
+  SX_CHECK(contains(s, "lazy") && !contains(s, "lazy cat"));
+  SX_CHECK(begins_with(s, string("the quick")) && ends_with(s, string("lazy dog")));
+  SX_CHECK(!ends_with(string("dog"), string("lazy dog")));
+
+  SX_CHECK(symbol_exist(str_view(s), "xyz") && !symbol_exist(str_view(s), "0123"));
+  SX_CHECK(consist_of(str_view("12321"), "123") && !consist_of(str_view("1234"), "123"));
+}
+
+static void test_search_strings()
+{
+  // std::string arguments take the view overloads
+  const string s = "abracadabra";
+  string what = "abra", none = "abc", sub = "cad";
+  SX_CHECK(sx::find(s, what) == 0 && sx::find(s, what, 1) == 7 && sx::rfind(s, what) == 7);
+  SX_CHECK(sx::find(s, none) == string::npos && sx::rfind(s, none) == string::npos);
+  SX_CHECK(contains(s, sub) && !contains(s, none));
+  SX_CHECK(begins_with(s, what) && ends_with(s, what) && !begins_with(s, sub));
+  SX_CHECK(symbol_exist(s, sub) && !symbol_exist(s, string("xyz")));
+  SX_CHECK(consist_of(s, string("abcdr")) && !consist_of(s, what));
+
+  string r = s;
+  SX_CHECK(replace_all_once(r, what, string("A")) == 2 && r == "AcadA");
+  replace_first(r, string("A"), sub);
+  replace_from_end(r, string("A"), none);
+  SX_CHECK(r == "cadcadabc");
+}
+
+static void test_symbols()
+{
+  string s = "value: 42";
+  string digits = "0123456789", letters = "xyz\xFF";
+  SX_CHECK(symbol_exist(s, digits) && !symbol_exist(s, letters));
+  SX_CHECK(consist_of(string("4242"), digits) && !consist_of(s, digits));
+  string t = "--a-b--";
+  erase_sym_right(t, string("-"));
+  erase_sym_left(t, string("-"));
+  SX_CHECK(t == "a-b");
+  change_sym(t, string("ab"), string("AB"));
+  SX_CHECK(t == "A-B");
+}
+
+static void test_split()
+{
+  vector<string> tokens;
+  // runs of separators give one break, a leading separator gives an empty token
+  SX_CHECK(split(tokens, "a,b,,c", ",") == 3 && tokens[2] == "c");
+  SX_CHECK(split(tokens, ",a;b,", ";,") == 3 && tokens[0].empty() && tokens[2] == "b");
+  int n = split<'\t', ' '>(tokens, "a\t b  c");
+  SX_CHECK(n == 3 && tokens[1] == "b" && tokens[2] == "c");
+
+  vector<str_view> views;
+  string line = "x;yy;zzz";
+  SX_CHECK(split(views, line, ";") == 3 && views[2] == str_view("zzz"));
+
+  string sym = "  -a-b- ";
+  erase_sym(sym, " -");
+  SX_CHECK(sym == "ab");
+}
+
+static void test_utf8_case()
+{
+  string s = "Hello, Мир! ΑΒΓ Ёжик";
+  utf8_lower(s);
+  SX_CHECK(s == "hello, мир! αβγ ёжик");
+  utf8_upper(s);
+  SX_CHECK(s == "HELLO, МИР! ΑΒΓ ЁЖИК");
+
+  string r = "Съешь ЖЕ ещё Этих";
+  sx::lower(r);
+  SX_CHECK(r == "съешь же ещё этих");
+  sx::upper(r);
+  SX_CHECK(r == "СЪЕШЬ ЖЕ ЕЩЁ ЭТИХ");
+
+  // chars out of the tables and broken sequences are kept
+  string t = "a\xE2\x82\xAC\xD0z\xFF";
+  utf8_upper(t);
+  SX_CHECK(t == "A\xE2\x82\xAC\xD0Z\xFF");
+
+  // long strings are processed by blocks
+  string l(1000, 'a');
+  l += "Я";
+  utf8_upper(l);
+  SX_CHECK(l == string(1000, 'A') + "Я");
+}
+
+static void test_match_template()
+{
+  SX_CHECK(match_template("AB123", "$$###"));
+  SX_CHECK(!match_template("AB12C", "$$###"));
+  SX_CHECK(match_template("a-z", "$*$"));
+  SX_CHECK(!match_template("abc", "$$"));
+}
+
+static void test_batch()
+{
+  vector<string> column;
+  for (int i = 0; i < 5000; i++)
+    column.push_back(i % 2 ? " x y " : "z ");
+  batch::erase_sym(column.begin(), column.end(), " ", 4, 64);
+  bool ok = true;
+  for (size_t i = 0; i < column.size(); i++)
+    ok = ok && column[i] == (i % 2 ? "xy" : "z");
+  SX_CHECK(ok);
+
+  vector<string> words;
+  for (int i = 0; i < 5000; i++)
+    words.push_back(i % 2 ? "Ёлка Tree" : "ПРИВЕТ");
+  batch::lower(words.begin(), words.end(), 4, 64);
+  ok = true;
+  for (size_t i = 0; i < words.size(); i++)
+    ok = ok && words[i] == (i % 2 ? "ёлка tree" : "привет");
+  SX_CHECK(ok);
+  batch::upper(words, 4);
+  SX_CHECK(words[0] == "ПРИВЕТ" && words[1] == "ЁЛКА TREE");
+}
+
+static void test_tf_string()
+{
+  tf_string empty;
+  SX_CHECK(empty.empty());
+  xstring s("Hello, World");
+  tf_string t = s;
+  SX_CHECK(t.replace("World", "There").lower() == string("hello, there"));
+  vector<string> parts = xstring("a b  c").split(" ");
+  SX_CHECK(parts.size() == 3 && xstring("-").join(parts) == "a-b-c");
+}
+
+int main()
+{
+  test_multi_replacer();
+  test_replace();
+  test_search();
+  test_search_strings();
+  test_symbols();
+  test_split();
+  test_utf8_case();
+  test_match_template();
+  test_batch();
+  test_tf_string();
+  return sx_test::result("str_test");
+}
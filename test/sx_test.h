@@ -0,0 +1,54 @@
+//!
+//! @file   sx_test.h
+//! @author Sholomov Dmitry
+//! @date   17.10.2026
+//! @brief  Minimal checks for the xhelpers tests: a failed check is printed and
+//!         the test returns a non-zero exit code.
+//!
+
+#ifndef SX_TEST_H
+#define SX_TEST_H
+
+#include <cstdio>
+#include <string>
+#include <fstream>
+
+namespace sx_test {
+
+inline int& failures()
+{
+  static int nFailures = 0;
+  return nFailures;
+}
+
+inline void check(bool ok, const char* expr, const char* file, int line)
+{
+  if (ok)
+    return;
+  fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+  failures()++;
+}
+
+//! Exit code of the test
+inline int result(const char* name)
+{
+  if (failures())
+    fprintf(stderr, "%s: %d check(s) failed\n", name, failures());
+  else
+    printf("%s: passed\n", name);
+  return failures() ? 1 : 0;
+}
+
+//! Writes data to the file, binary mode
+inline bool write_file(const char* filename, const std::string& data)
+{
+  std::ofstream os(filename, std::ios::binary);
+  os.write(data.data(), data.size());
+  return !os.fail();
+}
+
+} // namespace sx_test
+
+#define SX_CHECK(cond) sx_test::check((cond), #cond, __FILE__, __LINE__)
+
+#endif
@@ -0,0 +1,279 @@
+//!
+//! @file     xhelpers/sx_lineindex.cpp
+//! @author   Sholomov Dmitry
+//! @brief    Index of line start offsets of a text file kept in a sidecar file
+//!
+
+#include "../sx_lineindex.h"
+#include "../sx_mapfile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+namespace {
+
+const char lidx_magic[8] = { 'S', 'X', 'L', 'I', 'D', 'X', '2', 0 };
+const size_t lidx_sample = 4096;                      // bytes hashed at both ends of the data file
+
+void put_u64(std::vector<unsigned char>& out, sx_uint64 v)
+{
+  for (int i = 0; i < 8; i++)
+    out.push_back((unsigned char)(v >> (8 * i)));
+}
+
+bool get_u64(const unsigned char*& p, const unsigned char* e, sx_uint64& v)
+{
+  if (e - p < 8)
+    return false;
+  v = 0;
+  for (int i = 0; i < 8; i++)
+    v |= (sx_uint64)p[i] << (8 * i);
+  p += 8;
+  return true;
+}
+
+void put_varint(std::vector<unsigned char>& out, sx_uint64 v)
+{
+  while (v >= 0x80)
+  {
+    out.push_back((unsigned char)(v | 0x80));
+    v >>= 7;
+  }
+  out.push_back((unsigned char)v);
+}
+
+//! Checked version for loading: the varint must end before e and fit in 64 bits
+bool get_varint(const unsigned char*& p, const unsigned char* e, sx_uint64& v)
+{
+  v = 0;
+  for (int shift = 0; p < e && shift < 64; shift += 7)
+  {
+    unsigned char b = *p++;
+    if (shift == 63 && b > 1)
+      return false;
+    v |= (sx_uint64)(b & 0x7f) << shift;
+    if (!(b & 0x80))
+      return true;
+  }
+  return false;
+}
+
+sx_uint64 get_varint(const unsigned char*& p)
+{
+  sx_uint64 v = 0;
+  for (int shift = 0; ; shift += 7)
+  {
+    unsigned char b = *p++;
+    v |= (sx_uint64)(b & 0x7f) << shift;
+    if (!(b & 0x80))
+      return v;
+  }
+}
+
+//! FNV-1a hash of the bytes
+sx_uint64 fnv1a(sx_uint64 h, const char* p, size_t n)
+{
+  for (size_t i = 0; i < n; i++)
+    h = (h ^ (unsigned char)p[i]) * 0x100000001b3ULL;
+  return h;
+}
+
+} // namespace
+
+sx::line_index::line_index() :
+  checkpoints(), block_pos(), deltas(), nRows(0), nStride(64), cDelimLine('\n'), nFileSize(0), nFileTime(0), nFileSample(0), bValid(false)
+{
+}
+
+void sx::line_index::clear()
+{
+  checkpoints.clear();
+  block_pos.clear();
+  deltas.clear();
+  nRows = 0;
+  nFileSize = nFileTime = nFileSample = 0;
+  bValid = false;
+}
+
+bool sx::line_index::file_stamp(const char* filename, sx_uint64& size, sx_uint64& mtime)
+{
+#ifdef _MSC_VER
+  struct _stat64 st;
+  if (_stat64(filename, &st) != 0)
+    return false;
+#else
+  struct stat st;
+  if (stat(filename, &st) != 0)
+    return false;
+#endif
+  size = (sx_uint64)st.st_size;
+#if defined(_MSC_VER)
+  mtime = (sx_uint64)st.st_mtime * 1000000000u;
+#elif defined(__APPLE__)
+  mtime = (sx_uint64)st.st_mtimespec.tv_sec * 1000000000u + st.st_mtimespec.tv_nsec;
+#else
+  mtime = (sx_uint64)st.st_mtim.tv_sec * 1000000000u + st.st_mtim.tv_nsec;
+#endif
+  return true;
+}
+
+sx_uint64 sx::line_index::sample_hash(const char* data, sx_uint64 size)
+{
+  size_t n = (size_t)std::min<sx_uint64>(size, lidx_sample);
+  sx_uint64 h = fnv1a(0xcbf29ce484222325ULL, data, n);
+  return size > n ? fnv1a(h, data + size - n, n) : h;
+}
+
+bool sx::line_index::build(const char* filename, char delim_line, unsigned stride)
+{
+  clear();
+  nStride = stride > 0 ? stride : 1;
+  cDelimLine = delim_line;
+  mapped_file file(filename);
+  if (!file.is_open() || !file_stamp(filename, nFileSize, nFileTime))
+    return false;
+  nFileSample = sample_hash(file.data(), file.size());
+
+  const char* beg = file.data();
+  const char* end = beg + file.size();
+  checkpoints.reserve(file.size() / 4096 + 1);
+  deltas.reserve(file.size() / 64 + 16);
+  for (const char* cur = beg; cur < end; nRows++)
+  {
+    const char* eol = static_cast<const char*>(memchr(cur, delim_line, end - cur));
+    const char* next = eol ? eol + 1 : end;
+    if (nRows % nStride == 0)
+    {
+      checkpoints.push_back(cur - beg);
+      block_pos.push_back(deltas.size());
+    }
+    if (nRows % nStride != nStride - 1 && next < end)   // lengths are needed for the rows inside blocks only
+      put_varint(deltas, next - cur);
+    cur = next;
+  }
+  nFileSize = file.size();
+  bValid = true;
+  return true;
+}
+
+bool sx::line_index::offset(size_t row, sx_uint64& off) const
+{
+  if (!bValid || row >= nRows)
+    return false;
+  size_t blk = row / nStride;
+  off = checkpoints[blk];
+  const unsigned char* p = deltas.empty() ? NULL : &deltas[0] + block_pos[blk];
+  for (size_t i = row % nStride; i > 0; i--)
+    off += get_varint(p);
+  return true;
+}
+
+bool sx::line_index::save(const char* idxname) const
+{
+  if (!bValid)
+    return false;
+  std::vector<unsigned char> hdr(lidx_magic, lidx_magic + sizeof(lidx_magic));
+  put_u64(hdr, nFileSize);
+  put_u64(hdr, nFileTime);
+  put_u64(hdr, nFileSample);
+  put_u64(hdr, (unsigned char)cDelimLine);
+  put_u64(hdr, nStride);
+  put_u64(hdr, nRows);
+  put_u64(hdr, checkpoints.size());
+  put_u64(hdr, deltas.size());
+  for (size_t i = 0; i < checkpoints.size(); i++)
+  {
+    put_u64(hdr, checkpoints[i]);
+    put_u64(hdr, block_pos[i]);
+  }
+
+  FILE* f = fopen(idxname, "wb");
+  if (!f)
+    return false;
+  bool ok = fwrite(&hdr[0], 1, hdr.size(), f) == hdr.size() &&
+    (deltas.empty() || fwrite(&deltas[0], 1, deltas.size(), f) == deltas.size());
+  ok = fclose(f) == 0 && ok;
+  if (!ok)
+    remove(idxname);
+  return ok;
+}
+
+bool sx::line_index::load(const char* idxname, const char* filename, char delim_line)
+{
+  clear();
+  sx_uint64 size, mtime;
+  mapped_file file(filename);
+  if (!file.is_open() || !file_stamp(filename, size, mtime))
+    return false;
+  mapped_file idx(idxname);
+  if (!idx.is_open() || idx.size() < sizeof(lidx_magic) || memcmp(idx.data(), lidx_magic, sizeof(lidx_magic)) != 0)
+    return false;
+
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(idx.data()) + sizeof(lidx_magic);
+  const unsigned char* e = reinterpret_cast<const unsigned char*>(idx.data()) + idx.size();
+  sx_uint64 dl, stride, rows, nChk, nDeltas;
+  if (!get_u64(p, e, nFileSize) || !get_u64(p, e, nFileTime) || !get_u64(p, e, nFileSample) ||
+      !get_u64(p, e, dl) || !get_u64(p, e, stride) ||
+      !get_u64(p, e, rows) || !get_u64(p, e, nChk) || !get_u64(p, e, nDeltas))
+    return false;
+  if (nFileSize != size || nFileTime != mtime || nFileSize != file.size() ||
+      nFileSample != sample_hash(file.data(), file.size()) || dl != (unsigned char)delim_line || stride == 0 || stride > 0xFFFFFFFFu ||
+      nChk != (rows + stride - 1) / stride || nChk > (sx_uint64)(e - p) / 16 || (sx_uint64)(e - p) != nChk * 16 + nDeltas)
+  {
+    clear();
+    return false;
+  }
+  nStride = (unsigned)stride;
+  cDelimLine = delim_line;
+  nRows = (size_t)rows;
+  checkpoints.resize((size_t)nChk);
+  block_pos.resize((size_t)nChk);
+  for (size_t i = 0; i < checkpoints.size(); i++)
+  {
+    get_u64(p, e, checkpoints[i]);
+    get_u64(p, e, block_pos[i]);
+    if (block_pos[i] > nDeltas)
+    {
+      clear();
+      return false;
+    }
+  }
+  deltas.assign(p, e);
+
+  // every block is decoded once: its lengths must end at the next block and the rows must start inside the file
+  for (size_t blk = 0; blk < checkpoints.size(); blk++)
+  {
+    const unsigned char* q = deltas.data() + block_pos[blk];
+    const unsigned char* qe = deltas.data() + (blk + 1 < checkpoints.size() ? block_pos[blk + 1] : deltas.size());
+    size_t n = std::min<size_t>(nStride, nRows - blk * nStride) - 1;
+    sx_uint64 off = checkpoints[blk];
+    bool ok = q <= qe && off < nFileSize;
+    for (size_t i = 0; ok && i < n; i++)
+    {
+      sx_uint64 len;
+      ok = get_varint(q, qe, len) && len > 0 && len < nFileSize - off;
+      off += len;
+    }
+    if (!ok || q != qe)
+    {
+      clear();
+      return false;
+    }
+  }
+  bValid = true;
+  return true;
+}
+
+bool sx::line_index::open(const char* filename, char delim_line, unsigned stride)
+{
+  std::string idxname = sidecar_name(filename);
+  if (load(idxname.c_str(), filename, delim_line))
+    return true;
+  if (!build(filename, delim_line, stride))
+    return false;
+  save(idxname.c_str());                                // the index is usable even if it can't be saved
+  return true;
+}
@@ -0,0 +1,130 @@
+//!
+//! @file     xhelpers/sx_mapfile.cpp
+//! @author   Sholomov Dmitry
+//! @brief    Read-only memory mapping of a whole file
+//!
+
+#include "../sx_mapfile.h"
+
+#ifdef _MSC_VER
+#  ifndef NOMINMAX
+#     define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <sys/types.h>
+#  include <sys/stat.h>
+#  include <sys/mman.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+sx::mapped_file::mapped_file() :
+  pData(NULL), nSize(0), bOpen(false),
+#ifdef _MSC_VER
+  hFile(INVALID_HANDLE_VALUE), hMapping(NULL)
+#else
+  fd(-1)
+#endif
+{
+}
+
+sx::mapped_file::mapped_file(const char* filename) :
+  pData(NULL), nSize(0), bOpen(false),
+#ifdef _MSC_VER
+  hFile(INVALID_HANDLE_VALUE), hMapping(NULL)
+#else
+  fd(-1)
+#endif
+{
+  open(filename);
+}
+
+sx::mapped_file::~mapped_file()
+{
+  close();
+}
+
+bool sx::mapped_file::open(const char* filename)
+{
+  close();
+  if (!filename)
+    return false;
+
+#ifdef _MSC_VER
+  hFile = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                      FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  if (hFile == INVALID_HANDLE_VALUE)
+    return false;
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(hFile, &fileSize))
+  {
+    close();
+    return false;
+  }
+  nSize = static_cast<size_t>(fileSize.QuadPart);
+  if (nSize > 0)
+  {
+    hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (hMapping == NULL)
+    {
+      close();
+      return false;
+    }
+    pData = static_cast<const char*>(MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0));
+    if (pData == NULL)
+    {
+      close();
+      return false;
+    }
+  }
+#else
+  fd = ::open(filename, O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+  {
+    close();
+    return false;
+  }
+  nSize = static_cast<size_t>(st.st_size);
+  if (nSize > 0)
+  {
+    void* p = mmap(NULL, nSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED)
+    {
+      close();
+      return false;
+    }
+    madvise(p, nSize, MADV_SEQUENTIAL);
+    pData = static_cast<const char*>(p);
+  }
+#endif
+
+  bOpen = true;
+  return true;
+}
+
+void sx::mapped_file::close()
+{
+#ifdef _MSC_VER
+  if (pData)
+    UnmapViewOfFile(pData);
+  if (hMapping != NULL)
+    CloseHandle(hMapping);
+  if (hFile != INVALID_HANDLE_VALUE)
+    CloseHandle(hFile);
+  hMapping = NULL;
+  hFile = INVALID_HANDLE_VALUE;
+#else
+  if (pData)
+    munmap(const_cast<char*>(pData), nSize);
+  if (fd >= 0)
+    ::close(fd);
+  fd = -1;
+#endif
+  pData = NULL;
+  nSize = 0;
+  bOpen = false;
+}
@@ -0,0 +1,77 @@
+//!
+//! @file     xhelpers/sx_orderedwriter.cpp
+//! @author   Sholomov Dmitry
+//! @brief    Writer of buffers produced by several threads in their sequence order
+//!
+
+#include "../sx_orderedwriter.h"
+
+sx::ordered_writer::ordered_writer(std::ostream& _os, size_t max_pending) :
+  os(_os), pending(), nMaxPending(max_pending > 0 ? max_pending : 1), nNext(0), bFinish(false), bFail(false),
+  mtx(), cvCommit(), cvSpace(), th()
+{
+  th = std::thread(&ordered_writer::committer, this);
+}
+
+sx::ordered_writer::~ordered_writer()
+{
+  finish();
+}
+
+void sx::ordered_writer::submit(size_t seq, std::string& buf)
+{
+  std::unique_lock<std::mutex> lock(mtx);
+  while (seq >= nNext + nMaxPending)                    // the buffer nNext is always accepted, so waiting ends
+    cvSpace.wait(lock);
+  pending[seq].swap(buf);
+  if (seq == nNext)
+    cvCommit.notify_one();
+}
+
+void sx::ordered_writer::committer()
+{
+  std::unique_lock<std::mutex> lock(mtx);
+  for (;;)
+  {
+    std::map<size_t, std::string>::iterator it = pending.begin();
+    if (it == pending.end() || it->first != nNext)
+    {
+      if (bFinish)
+        return;
+      cvCommit.wait(lock);
+      continue;
+    }
+    std::string buf;
+    buf.swap(it->second);
+    pending.erase(it);
+    lock.unlock();                                      // producers go on while the buffer is written
+    if (!bFail)
+    {
+      os.write(buf.data(), buf.size());
+      bFail = !os;
+    }
+    lock.lock();
+    nNext++;
+    cvSpace.notify_all();
+  }
+}
+
+size_t sx::ordered_writer::written() const
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  return nNext;
+}
+
+bool sx::ordered_writer::finish()
+{
+  if (th.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      bFinish = true;
+    }
+    cvCommit.notify_one();
+    th.join();
+  }
+  return !bFail && pending.empty();
+}
@@ -0,0 +1,144 @@
+//!
+//! @file     xhelpers/sx_readahead.cpp
+//! @author   Sholomov Dmitry
+//! @brief    Input stream buffer reading the file ahead by a background thread
+//!
+
+#include "../sx_readahead.h"
+
+#ifdef _MSC_VER
+#  define sx_fseek _fseeki64
+#  define sx_ftell _ftelli64
+#else
+#  define sx_fseek fseeko
+#  define sx_ftell ftello
+#endif
+
+sx::readahead_buf::readahead_buf(const char* filename, std::streamoff offset, size_t buf_size) :
+  std::streambuf(), file(NULL), bufs(), filled(), ready(), cur(-1), bStop(false), bEof(false), base(0), mtx(), cv(), th()
+{
+  file = filename ? std::fopen(filename, "rb") : NULL;
+  if (!file)
+    return;
+  std::setvbuf(file, NULL, _IONBF, 0);                  // large reads go directly to our buffers
+  for (int i = 0; i < 2; i++)
+    bufs[i].resize(buf_size > 0 ? buf_size : 1);
+  start(offset);
+}
+
+sx::readahead_buf::~readahead_buf()
+{
+  stop();
+  if (file)
+    std::fclose(file);
+}
+
+void sx::readahead_buf::start(std::streamoff offset)
+{
+  if (sx_fseek(file, offset, SEEK_SET) != 0)
+    offset = sx_ftell(file);
+  base = offset;
+  filled[0] = filled[1] = 0;
+  ready[0] = ready[1] = false;
+  cur = -1;
+  bStop = false;
+  bEof = false;
+  setg(NULL, NULL, NULL);
+  th = std::thread(&readahead_buf::worker, this);
+}
+
+void sx::readahead_buf::stop()
+{
+  if (!th.joinable())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    bStop = true;
+  }
+  cv.notify_all();
+  th.join();
+}
+
+void sx::readahead_buf::worker()
+{
+  for (int i = 0; ; i ^= 1)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      while (ready[i] && !bStop)
+        cv.wait(lock);
+      if (bStop)
+        return;
+    }
+    size_t n = std::fread(&bufs[i][0], 1, bufs[i].size(), file);
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      filled[i] = n;
+      ready[i] = true;
+    }
+    cv.notify_all();
+    if (n == 0)                                         // end of file or error, the empty buffer marks it
+      return;
+  }
+}
+
+sx::readahead_buf::int_type sx::readahead_buf::underflow()
+{
+  if (gptr() < egptr())
+    return traits_type::to_int_type(*gptr());
+  if (bEof || !file)
+    return traits_type::eof();
+
+  int next = cur < 0 ? 0 : cur ^ 1;
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    if (cur >= 0)
+    {
+      base += filled[cur];
+      ready[cur] = false;                               // the consumed buffer goes back to the reader
+      cv.notify_all();
+    }
+    while (!ready[next])
+      cv.wait(lock);
+  }
+  cur = next;
+  if (filled[cur] == 0)
+  {
+    bEof = true;
+    setg(NULL, NULL, NULL);
+    return traits_type::eof();
+  }
+  char* p = &bufs[cur][0];
+  setg(p, p, p + filled[cur]);
+  return traits_type::to_int_type(*p);
+}
+
+sx::readahead_buf::pos_type sx::readahead_buf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+  if (!file || !(which & std::ios_base::in))
+    return pos_type(off_type(-1));
+  std::streamoff pos = base + (gptr() - eback());
+  if (dir == std::ios_base::cur && off == 0)            // tellg does not disturb reading
+    return pos_type(pos);
+
+  stop();
+  if (dir == std::ios_base::beg)
+    pos = off;
+  else if (dir == std::ios_base::cur)
+    pos += off;
+  else
+  {
+    if (sx_fseek(file, off, SEEK_END) != 0)
+      return pos_type(off_type(-1));
+    pos = sx_ftell(file);
+  }
+  if (pos < 0)
+    return pos_type(off_type(-1));
+  start(pos);
+  return pos_type(base);
+}
+
+sx::readahead_buf::pos_type sx::readahead_buf::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+  return seekoff(off_type(pos), std::ios_base::beg, which);
+}
@@ -0,0 +1,172 @@
+//!
+//! @file     xhelpers/sx_stringpool.cpp
+//! @author   Sholomov Dmitry
+//! @brief    Pool of interned strings shared by threads
+//!
+
+#include "../sx_stringpool.h"
+
+#include <cstring>
+
+sx::string_pool::string_pool() :
+  shards(), nNext(1), mtxDir(), dir(NULL), nDirSize(0), nBlocks(0), dirs()
+{
+  set_entry(0, detail::pooled_empty());
+}
+
+sx::string_pool::~string_pool()
+{
+  for (unsigned s = 0; s < nShards; s++)
+    for (size_t i = 0; i < shards[s].chunks.size(); i++)
+      delete[] shards[s].chunks[i];
+  std::atomic<entry*>* d = dir.load();
+  for (size_t b = 0; b < nBlocks.load(); b++)
+    delete[] d[b].load();
+  for (size_t i = 0; i < dirs.size(); i++)
+    delete[] dirs[i];
+}
+
+// FNV-1a
+sx_uint64 sx::string_pool::hash(str_view s)
+{
+  sx_uint64 h = 14695981039346656037ULL;
+  for (size_t i = 0; i < s.size(); i++)
+  {
+    h ^= (unsigned char)s[i];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+const char* sx::string_pool::lookup(const shard& sh, str_view s, sx_uint64 h, size_t& pos)
+{
+  size_t mask = sh.slots.size() - 1;
+  for (pos = (size_t)h & mask; sh.slots[pos].p; pos = (pos + 1) & mask)
+  {
+    const char* p = sh.slots[pos].p;
+    if (sh.slots[pos].hash == (unsigned)h && pooled_string(p).size() == s.size() && memcmp(p, s.data(), s.size()) == 0)
+      return p;
+  }
+  return NULL;
+}
+
+char* sx::string_pool::alloc(shard& sh, size_t n)
+{
+  n = (n + 7) & ~(size_t)7;                             // headers are aligned
+  sh.nBytes += n;
+  if (n > chunk_size / 4)
+  {
+    char* p = new char[n];
+    sh.chunks.insert(sh.chunks.end() - (sh.chunks.empty() ? 0 : 1), p);   // the last chunk is kept for filling
+    return p;
+  }
+  if (sh.nChunkUsed + n > chunk_size)
+  {
+    sh.chunks.push_back(new char[chunk_size]);
+    sh.nChunkUsed = 0;
+  }
+  char* p = sh.chunks.back() + sh.nChunkUsed;
+  sh.nChunkUsed += n;
+  return p;
+}
+
+void sx::string_pool::set_entry(id_type id, const char* p)
+{
+  size_t b = id >> block_bits;
+  if (b >= nBlocks.load(std::memory_order_acquire))
+  {
+    std::lock_guard<std::mutex> lock(mtxDir);
+    while (b >= nBlocks.load())
+    {
+      if (nBlocks.load() == nDirSize)
+      {
+        size_t nSize = nDirSize ? nDirSize * 2 : 16;
+        std::atomic<entry*>* d = new std::atomic<entry*>[nSize];
+        for (size_t i = 0; i < nSize; i++)
+          d[i].store(i < nDirSize ? dir.load()[i].load() : NULL);
+        dirs.push_back(d);                              // readers may still use the old directory
+        dir.store(d, std::memory_order_release);
+        nDirSize = nSize;
+      }
+      dir.load()[nBlocks.load()].store(new entry[block_size], std::memory_order_release);
+      nBlocks.store(nBlocks.load() + 1, std::memory_order_release);
+    }
+  }
+  dir.load(std::memory_order_acquire)[b].load(std::memory_order_acquire)[id & (block_size - 1)] = p;
+}
+
+sx::pooled_string sx::string_pool::intern(str_view s)
+{
+  if (s.empty())
+    return pooled_string();
+  sx_uint64 h = hash(s);
+  shard& sh = shards[h >> (64 - shard_bits)];
+  std::lock_guard<std::mutex> lock(sh.mtx);
+  size_t pos = 0;
+  if (!sh.slots.empty())
+  {
+    const char* p = lookup(sh, s, h, pos);
+    if (p)
+      return pooled_string(p);
+  }
+  if ((sh.nCount + 1) * 2 > sh.slots.size())
+  {
+    std::vector<slot> old;
+    old.swap(sh.slots);
+    slot empty = { NULL, 0 };
+    sh.slots.assign(old.empty() ? 64 : old.size() * 2, empty);
+    size_t mask = sh.slots.size() - 1;
+    for (size_t i = 0; i < old.size(); i++)
+      if (old[i].p)
+      {
+        size_t j = hash(pooled_string(old[i].p).view()) & mask;
+        while (sh.slots[j].p)
+          j = (j + 1) & mask;
+        sh.slots[j] = old[i];
+      }
+    lookup(sh, s, h, pos);                              // free slot for s
+  }
+
+  id_type id = nNext.fetch_add(1);
+  char* rec = alloc(sh, sizeof(detail::pooled_header) + s.size() + 1);
+  detail::pooled_header* hdr = reinterpret_cast<detail::pooled_header*>(rec);
+  hdr->id = id;
+  hdr->len = (unsigned)s.size();
+  char* p = rec + sizeof(detail::pooled_header);
+  memcpy(p, s.data(), s.size());
+  p[s.size()] = 0;
+  set_entry(id, p);
+  sh.slots[pos].p = p;
+  sh.slots[pos].hash = (unsigned)h;
+  sh.nCount++;
+  return pooled_string(p);
+}
+
+bool sx::string_pool::find(str_view s, pooled_string& ps) const
+{
+  if (s.empty())
+  {
+    ps = pooled_string();
+    return true;
+  }
+  sx_uint64 h = hash(s);
+  shard& sh = shards[h >> (64 - shard_bits)];
+  std::lock_guard<std::mutex> lock(sh.mtx);
+  size_t pos;
+  const char* p = sh.slots.empty() ? NULL : lookup(sh, s, h, pos);
+  if (p)
+    ps = pooled_string(p);
+  return p != NULL;
+}
+
+size_t sx::string_pool::memory() const
+{
+  size_t n = 0;
+  for (unsigned s = 0; s < nShards; s++)
+  {
+    std::lock_guard<std::mutex> lock(shards[s].mtx);
+    n += shards[s].nBytes + shards[s].slots.size() * sizeof(slot);
+  }
+  std::lock_guard<std::mutex> lock(mtxDir);
+  return n + nBlocks.load() * block_size * sizeof(entry) + nDirSize * sizeof(std::atomic<entry*>);
+}
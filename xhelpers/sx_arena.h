@@ -0,0 +1,162 @@
+//!
+//!@file    xhelpers/sx_arena.h
+//!@author  Sholomov Dmitry
+//!@date    17.10.2026
+//!@brief   Monotonic arena and the STL allocator taking memory from it
+//!
+
+#ifndef SX_ARENA_H
+#define SX_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <utility>
+
+namespace sx {
+
+//! @class monotonic_arena xhelpers/sx_arena.h
+//! @brief Memory taken from big blocks by moving a pointer. deallocate() does nothing, the memory is
+//!        returned by release() or the destructor at once, so short-lived objects of a request cost
+//!        no heap calls of their own. The arena is not thread-safe, use one arena per thread or request.
+//!          sx::monotonic_arena arena;
+//!          sx::arena_string s("text", sx::arena_allocator<char>(arena));
+class monotonic_arena
+{
+public:
+  static const size_t default_block = 64 * 1024;
+
+  explicit monotonic_arena(size_t _nBlock = default_block) :
+    blocks(), pCur(NULL), nLeft(0), nBlock(_nBlock ? _nBlock : default_block), nUsed(0), nReserved(0) {}
+  ~monotonic_arena() { release(); }
+
+  //! n bytes aligned to align (power of 2). Requests larger than a quarter of the block get their own block
+  void* allocate(size_t n, size_t align = sizeof(void*))
+  {
+    size_t pad = (align - ((size_t)pCur & (align - 1))) & (align - 1);
+    if (n + pad > nLeft)
+    {
+      if (n > nBlock / 4)
+        return alloc_block(n + align, false, align);
+      alloc_block(nBlock, true, align);
+      pad = (align - ((size_t)pCur & (align - 1))) & (align - 1);
+    }
+    char* p = pCur + pad;
+    pCur = p + n;
+    nLeft -= n + pad;
+    nUsed += n;
+    return p;
+  }
+
+  void deallocate(void*, size_t) {}                     //!< The memory is kept till release()
+
+  //! Frees all blocks, the memory given before must not be used any more
+  void release()
+  {
+    for (size_t i = 0; i < blocks.size(); i++)
+      ::operator delete(blocks[i]);
+    blocks.clear();
+    pCur = NULL;
+    nLeft = 0;
+    nUsed = 0;
+    nReserved = 0;
+  }
+
+  size_t used() const { return nUsed; }                 //!< Bytes given by allocate()
+  size_t reserved() const { return nReserved; }         //!< Bytes of the blocks
+
+private:
+  monotonic_arena(const monotonic_arena &);             //!< Конструктор копирования (запрещен)
+  monotonic_arena &operator=(const monotonic_arena &);  //!< Оператор присваивания (запрещен)
+
+  //! New block, the current one is replaced if bCurrent. Returns the aligned start of the block
+  char* alloc_block(size_t n, bool bCurrent, size_t align)
+  {
+    char* p = static_cast<char*>(::operator new(n));
+    blocks.push_back(p);
+    nReserved += n;
+    if (bCurrent)
+    {
+      pCur = p;
+      nLeft = n;
+      return p;
+    }
+    nUsed += n - align;
+    return p + ((align - ((size_t)p & (align - 1))) & (align - 1));
+  }
+
+  std::vector<char*> blocks;
+  char* pCur;                                           //!< Free part of the current block
+  size_t nLeft;
+  size_t nBlock;
+  size_t nUsed;
+  size_t nReserved;
+};
+
+//! @class arena_allocator xhelpers/sx_arena.h
+//! @brief STL allocator taking memory from a monotonic_arena. The default allocator uses the heap, so
+//!        containers of arena objects may be created without an arena. Allocators are equal if they use the same arena
+template <class T>
+class arena_allocator
+{
+public:
+  typedef T value_type;
+  typedef T* pointer;
+  typedef const T* const_pointer;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+
+  template <class U>
+  struct rebind
+  {
+    typedef arena_allocator<U> other;
+  };
+
+  arena_allocator() : arena(NULL) {}
+  arena_allocator(monotonic_arena& _arena) : arena(&_arena) {}
+  template <class U>
+  arena_allocator(const arena_allocator<U>& a) : arena(a.get_arena()) {}
+
+  T* allocate(size_t n, const void* = NULL)
+  {
+    if (n > max_size())
+      throw std::bad_alloc();
+    return static_cast<T*>(arena ? arena->allocate(n * sizeof(T), alignof(T)) : ::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T* p, size_t n)
+  {
+    if (arena)
+      arena->deallocate(p, n * sizeof(T));
+    else
+      ::operator delete(p);
+  }
+
+  size_t max_size() const { return (size_t)-1 / sizeof(T); }
+
+  template <class U, class... Args>
+  void construct(U* p, Args&&... args) { ::new((void*)p) U(std::forward<Args>(args)...); }
+
+  template <class U>
+  void destroy(U* p) { p->~U(); }
+
+  T* address(T& x) const { return &x; }
+  const T* address(const T& x) const { return &x; }
+
+  monotonic_arena* get_arena() const { return arena; }
+
+private:
+  monotonic_arena* arena;                               //!< NULL for the heap
+};
+
+template <class T, class U>
+inline bool operator==(const arena_allocator<T>& a, const arena_allocator<U>& b) { return a.get_arena() == b.get_arena(); }
+
+template <class T, class U>
+inline bool operator!=(const arena_allocator<T>& a, const arena_allocator<U>& b) { return a.get_arena() != b.get_arena(); }
+
+} // namespace sx
+
+#endif // SX_ARENA_H
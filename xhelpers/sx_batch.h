@@ -0,0 +1,257 @@
+//!
+//!@file    xhelpers/sx_batch.h
+//!@author  Sholomov Dmitry
+//!@date    17.10.2026
+//!@brief   Parallel batch versions of the sx_str.h transformations over ranges of strings
+//!
+//! The range is cut into chunks of consecutive strings, the chunks are taken by OpenMP threads.
+//! Each string is transformed exactly as the single-string function does, the tables of the
+//! transformation (charset, charmap, separators) are built once per batch.
+//!   sx::batch::lower(column);
+//!   sx::batch::erase_sym(column.begin(), column.end(), " \t");
+//!
+
+#ifndef SX_BATCH_H
+#define SX_BATCH_H
+
+#include <string>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <xhelpers/sx_str.h>
+#include <xhelpers/sx_utf8case.h>
+
+namespace sx {
+namespace batch {
+
+//! Strings per chunk: enough work to hide the scheduling, few enough to keep the chunk in the cache
+const size_t default_chunk = 4096;
+
+namespace detail {
+
+//! Calls body(b, e) for the chunks [b,e) of nChunk indices of [0,n) using nThreads threads, 0 - OpenMP default.
+//! Chunks are scheduled dynamically, a single chunk is processed by the calling thread
+template <class Body>
+void for_chunks(size_t n, const Body& body, int nThreads, size_t nChunk)
+{
+  if (nChunk == 0)
+    nChunk = 1;
+  const ptrdiff_t nChunks = (ptrdiff_t)((n + nChunk - 1) / nChunk);
+#ifdef _OPENMP
+  if (nThreads <= 0)
+    nThreads = omp_get_max_threads();
+  if (nChunks > 1 && nThreads > 1)
+  {
+    #pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+    for (ptrdiff_t c = 0; c < nChunks; c++)
+    {
+      size_t b = (size_t)c * nChunk;
+      body(b, std::min(b + nChunk, n));
+    }
+    return;
+  }
+#else
+  (void)nThreads;
+  (void)nChunks;
+#endif
+  if (n > 0)
+    body(0, n);
+}
+
+template <class It, class Fn>
+struct each_body
+{
+  It first;
+  const Fn& fn;
+  each_body(It _first, const Fn& _fn) : first(_first), fn(_fn) {}
+  void operator()(size_t b, size_t e) const
+  {
+    typedef typename std::iterator_traits<It>::difference_type diff_t;
+    for (It it = first + (diff_t)b, end = first + (diff_t)e; it != end; ++it)
+      fn(*it);
+  }
+};
+
+struct change_sym_fn
+{
+  const charmap& cm;
+  explicit change_sym_fn(const charmap& _cm) : cm(_cm) {}
+  void operator()(std::string& s) const { sx::change_sym(s, cm); }
+};
+
+struct utf8_lower_fn
+{
+  void operator()(std::string& s) const { sx::utf8_lower(s); }
+};
+
+struct utf8_upper_fn
+{
+  void operator()(std::string& s) const { sx::utf8_upper(s); }
+};
+
+struct erase_sym_fn
+{
+  const charset& cs;
+  explicit erase_sym_fn(const charset& _cs) : cs(_cs) {}
+  void operator()(std::string& s) const { sx::erase_sym(s, cs); }
+};
+
+struct replace_all_fn
+{
+  const std::string& sFrom;
+  const std::string& sTo;
+  replace_all_fn(const std::string& _sFrom, const std::string& _sTo) : sFrom(_sFrom), sTo(_sTo) {}
+  void operator()(std::string& s) const { sx::replace_all(s, sFrom, sTo); }
+};
+
+//! Tokens of split of the strings [b,e), the separator set is prepared once for all strings
+template <class It, class Token>
+struct split_body
+{
+  It first;
+  std::vector<std::vector<Token> >& out;
+  const sx::detail::sep_finder<char>& sep;
+  split_body(It _first, std::vector<std::vector<Token> >& _out, const sx::detail::sep_finder<char>& _sep) :
+    first(_first), out(_out), sep(_sep) {}
+
+  void operator()(size_t b, size_t e) const
+  {
+    typedef typename std::iterator_traits<It>::difference_type diff_t;
+    for (size_t i = b; i < e; i++)
+    {
+      str_view s(first[(diff_t)i]);
+      std::vector<Token>& vsVec = out[i];
+      vsVec.clear();
+      split_range::iterator it(&sep, s.begin(), s.end()), end(&sep, s.end(), s.end());
+      for (; it != end; ++it)
+        vsVec.push_back(Token(it->begin(), it->end()));
+    }
+  }
+};
+
+} // namespace detail
+
+//! Calls fn(*it) for every element of the random access range [first,last) using nThreads threads,
+//! 0 - OpenMP default. Chunks of nChunk consecutive elements are taken by the threads dynamically.
+//! fn is shared by the threads and must be safe to call concurrently
+template <class It, class Fn>
+void for_each(It first, It last, const Fn& fn, int nThreads = 0, size_t nChunk = default_chunk)
+{
+  detail::for_chunks((size_t)(last - first), detail::each_body<It, Fn>(first, fn), nThreads, nChunk);
+}
+
+//! change_sym of every string by the map
+template <class It>
+void change_sym(It first, It last, const charmap& cmMap, int nThreads = 0, size_t nChunk = default_chunk)
+{
+  for_each(first, last, detail::change_sym_fn(cmMap), nThreads, nChunk);
+}
+
+template <class It>
+void change_sym(It first, It last, const std::string& sSymbolsFrom, const std::string& sSymbolsTo,
+  int nThreads = 0, size_t nChunk = default_chunk)
+{
+  change_sym(first, last, charmap(sSymbolsFrom, sSymbolsTo), nThreads, nChunk);
+}
+
+//! Lower and upper case of every UTF-8 string by sx::utf8_lower and sx::utf8_upper
+template <class It>
+void lower(It first, It last, int nThreads = 0, size_t nChunk = default_chunk)
+{
+  for_each(first, last, detail::utf8_lower_fn(), nThreads, nChunk);
+}
+
+template <class It>
+void upper(It first, It last, int nThreads = 0, size_t nChunk = default_chunk)
+{
+  for_each(first, last, detail::utf8_upper_fn(), nThreads, nChunk);
+}
+
+//! erase_sym of every string
+template <class It>
+void erase_sym(It first, It last, const charset& csSymbols, int nThreads = 0, size_t nChunk = default_chunk)
+{
+  for_each(first, last, detail::erase_sym_fn(csSymbols), nThreads, nChunk);
+}
+
+template <class It>
+void erase_sym(It first, It last, const char* pSymbols, int nThreads = 0, size_t nChunk = default_chunk)
+{
+  erase_sym(first, last, charset(pSymbols), nThreads, nChunk);
+}
+
+template <class It>
+void erase_sym(It first, It last, const std::string& sSymbols, int nThreads = 0, size_t nChunk = default_chunk)
+{
+  erase_sym(first, last, charset(sSymbols), nThreads, nChunk);
+}
+
+//! replace_all in every string, the result is the same as of sx::replace_all
+template <class It>
+void replace_all(It first, It last, const std::string& sFrom, const std::string& sTo,
+  int nThreads = 0, size_t nChunk = default_chunk)
+{
+  for_each(first, last, detail::replace_all_fn(sFrom, sTo), nThreads, nChunk);
+}
+
+//! split of every string of [first,last) by the separators, out[i] gets the tokens of the i-th string.
+//! The elements are std::string, str_view or other types convertible to str_view. Tokens are strings or
+//! views into the source strings (vector<vector<str_view>>), the views are valid while the sources are kept.
+//! Returns the total number of tokens
+template <class It, class Token>
+size_t split(It first, It last, std::vector<std::vector<Token> >& out, str_view sSep,
+  int nThreads = 0, size_t nChunk = default_chunk)
+{
+  const size_t n = (size_t)(last - first);
+  out.resize(n);
+  sx::detail::sep_finder<char> sep(sSep);
+  detail::for_chunks(n, detail::split_body<It, Token>(first, out, sep), nThreads, nChunk);
+  size_t nTokens = 0;
+  for (size_t i = 0; i < n; i++)
+    nTokens += out[i].size();
+  return nTokens;
+}
+
+//! Versions taking the whole container: vector<string>, deque<string> or other random access range
+template <class Range>
+void lower(Range& r, int nThreads = 0) { lower(r.begin(), r.end(), nThreads); }
+
+template <class Range>
+void upper(Range& r, int nThreads = 0) { upper(r.begin(), r.end(), nThreads); }
+
+template <class Range>
+void change_sym(Range& r, const charmap& cmMap, int nThreads = 0) { change_sym(r.begin(), r.end(), cmMap, nThreads); }
+
+template <class Range>
+void change_sym(Range& r, const std::string& sSymbolsFrom, const std::string& sSymbolsTo, int nThreads = 0)
+{
+  change_sym(r.begin(), r.end(), sSymbolsFrom, sSymbolsTo, nThreads);
+}
+
+template <class Range>
+void erase_sym(Range& r, const charset& csSymbols, int nThreads = 0) { erase_sym(r.begin(), r.end(), csSymbols, nThreads); }
+
+template <class Range>
+void erase_sym(Range& r, const char* pSymbols, int nThreads = 0) { erase_sym(r.begin(), r.end(), pSymbols, nThreads); }
+
+template <class Range>
+void replace_all(Range& r, const std::string& sFrom, const std::string& sTo, int nThreads = 0)
+{
+  replace_all(r.begin(), r.end(), sFrom, sTo, nThreads);
+}
+
+template <class Range, class Token>
+size_t split(const Range& r, std::vector<std::vector<Token> >& out, str_view sSep, int nThreads = 0)
+{
+  return split(r.begin(), r.end(), out, sSep, nThreads);
+}
+
+} // namespace batch
+} // namespace sx
+
+#endif // SX_BATCH_H
@@ -9,6 +9,9 @@
 
 #include <string>
 #include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <cstdio>
 
 namespace sx {
 
@@ -102,6 +105,183 @@ inline std::string string_cast(unsigned long num)
     return string_cast((long)num);
 }
 
+// Parsing numbers directly from character ranges [b,e) without intermediate strings.
+// The whole range must be a number, otherwise false is returned and num is not changed
+
+//! Integer: optional sign and decimal digits or 0x-prefixed hex digits, overflow is an error
+inline bool parse_int(const char* b, const char* e, long long& num)
+{
+    bool neg = false;
+    if(b<e && (*b=='-' || *b=='+'))
+        neg = *b++=='-';
+    if(b>=e)
+        return false;
+    const unsigned long long limit = neg ? 9223372036854775808ULL : 9223372036854775807ULL;
+    unsigned long long val = 0;
+    if(e-b>2 && b[0]=='0' && (b[1]=='x' || b[1]=='X')) //hex
+    {
+        for(b+=2; b<e; b++)
+        {
+            unsigned d;
+            if(*b>='0' && *b<='9') d = *b-'0';
+            else if(*b>='a' && *b<='f') d = *b-'a'+10;
+            else if(*b>='A' && *b<='F') d = *b-'A'+10;
+            else return false;
+            if(val > (limit-d)/16)
+                return false;
+            val = val*16+d;
+        }
+    }
+    else
+    {
+        for(; b<e; b++)
+        {
+            unsigned d = (unsigned)(*b-'0');
+            if(d>9 || val > (limit-d)/10)
+                return false;
+            val = val*10+d;
+        }
+    }
+    num = neg ? (long long)(0ULL-val) : (long long)val;
+    return true;
+}
+
+inline bool parse_int(const char* b, const char* e, int& num)
+{
+    long long val;
+    if(!parse_int(b, e, val) || val<-2147483647LL-1 || val>2147483647LL)
+        return false;
+    num = static_cast<int>(val);
+    return true;
+}
+
+//! Floating point number in decimal notation. Numbers up to 19 significant digits with small exponent are
+//! converted exactly by integer arithmetics, the others (and inf/nan) are passed to strtod
+inline bool parse_double(const char* b, const char* e, double& num)
+{
+    static const double pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+    const char* p = b;
+    bool neg = false;
+    if(p<e && (*p=='-' || *p=='+'))
+        neg = *p++=='-';
+    unsigned long long mant = 0;
+    int digits = 0, frac = 0, nDigits = 0;
+    for(; p<e && (unsigned)(*p-'0')<=9; p++, nDigits++)
+        if(mant || *p!='0')
+            mant = mant*10+(*p-'0'), digits++;
+    if(p<e && *p=='.')
+        for(p++; p<e && (unsigned)(*p-'0')<=9; p++, nDigits++, frac++)
+            if(mant || *p!='0')
+                mant = mant*10+(*p-'0'), digits++;
+    int exp10 = 0;
+    bool fast = nDigits>0 && digits<=19;
+    if(fast && p<e && (*p=='e' || *p=='E'))
+    {
+        p++;
+        bool eneg = false;
+        if(p<e && (*p=='-' || *p=='+'))
+            eneg = *p++=='-';
+        if(p>=e)
+            return false;
+        for(; p<e && (unsigned)(*p-'0')<=9 && exp10<100000; p++)
+            exp10 = exp10*10+(*p-'0');
+        if(eneg)
+            exp10 = -exp10;
+    }
+    exp10 -= frac;
+    if(fast && p==e && mant<(1ULL<<53) && exp10>=-22 && exp10<=22)
+    {
+        double val = static_cast<double>(mant);
+        val = exp10<0 ? val/pow10[-exp10] : val*pow10[exp10];
+        num = neg ? -val : val;
+        return true;
+    }
+
+    char buf[64];
+    std::string sbuf;
+    const char* str = buf;
+    if(e-b < (long)sizeof(buf))
+    {
+        memcpy(buf, b, e-b);
+        buf[e-b] = 0;
+    }
+    else
+    {
+        sbuf.assign(b, e);
+        str = sbuf.c_str();
+    }
+    char* end = 0;
+    double val = strtod(str, &end);
+    if(end==str || *end!=0 || isspace((unsigned char)*str))
+        return false;
+    num = val;
+    return true;
+}
+
+// Formatting numbers into character buffers without streams and locales.
+// Functions return the end of the written chars, the buffer is not zero-terminated
+
+//! Decimal digits of num, buf must have room for 20 chars
+inline char* format_uint(char* buf, unsigned long long num)
+{
+    static const char digits2[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+    char tmp[20];
+    char* p = tmp + sizeof(tmp);
+    while(num>=100)
+    {
+        unsigned i = static_cast<unsigned>(num%100)*2;
+        num /= 100;
+        *--p = digits2[i+1];
+        *--p = digits2[i];
+    }
+    if(num>=10)
+    {
+        unsigned i = static_cast<unsigned>(num)*2;
+        *--p = digits2[i+1];
+        *--p = digits2[i];
+    }
+    else
+        *--p = static_cast<char>('0'+num);
+    size_t n = tmp + sizeof(tmp) - p;
+    memcpy(buf, p, n);
+    return buf + n;
+}
+
+//! Decimal digits of num with '-' for negatives, buf must have room for 20 chars
+inline char* format_int(char* buf, long long num)
+{
+    if(num<0)
+    {
+        *buf++ = '-';
+        return format_uint(buf, 0ULL-static_cast<unsigned long long>(num));
+    }
+    return format_uint(buf, static_cast<unsigned long long>(num));
+}
+
+//! %.*g representation with the given precision, integral values are formatted as integers.
+//! 17 digits give the exact round trip, but not the shortest form: 0.1 is 0.10000000000000001.
+//! Precisions above 17 are taken as 17, so the output fits in 32 chars which buf must have room for
+inline char* format_double(char* buf, double num, int precision=17)
+{
+    if(precision>17)
+        precision = 17;                                 // no more digits in a double, "-d.16 digits e-308" is 24 chars
+    double limit = 9007199254740992.0;                  // 2^53, integers are exact below it
+    if(precision<16)
+    {
+        limit = 1;
+        for(int i=0; i<precision; i++)
+            limit *= 10;                                // %g uses exponent notation from 10^precision
+    }
+    if(num>-limit && num<limit && num==static_cast<double>(static_cast<long long>(num)) && (num!=0 || 1/num>0))
+        return format_int(buf, static_cast<long long>(num));
+    int n = snprintf(buf, 32, "%.*g", precision, num);
+    return buf + (n>0 ? n : 0);
+}
+
 }; // namespace sx;
 
 
@@ -0,0 +1,170 @@
+//!
+//!@file    xhelpers/sx_charset.h
+//!@author  Sholomov Dmitry
+//!@date    17.10.2026
+//!@brief   Byte sets and byte translation maps with constant time lookup
+//!
+
+#ifndef SX_CHARSET_H
+#define SX_CHARSET_H
+
+#include <string>
+#include <cstddef>
+#include <type_traits>
+
+#include <xhelpers/sx_delimscan.h>
+
+namespace sx {
+
+namespace detail {
+
+// Bit word k (bytes 64*k..64*k+63) of the set of bytes of [s,s+n). The halves are taken separately,
+// so the recursion depth is log2(n) when the constructor is evaluated at runtime
+constexpr sx_uint64 charset_word(const char* s, size_t n, unsigned k)
+{
+  return n == 0 ? 0 :
+    n == 1 ? (((unsigned char)*s >> 6) == k ? (sx_uint64)1 << ((unsigned char)*s & 63) : 0) :
+    charset_word(s, n / 2, k) | charset_word(s + n / 2, n - n / 2, k);
+}
+
+constexpr size_t charset_len_join(size_t nLeft, const char* s, size_t n);
+
+// Index of the first zero byte of [s,s+n) or n, by halves as charset_word
+constexpr size_t charset_len(const char* s, size_t n)
+{
+  return n == 0 ? 0 : n == 1 ? (*s == 0 ? 0 : 1) : charset_len_join(charset_len(s, n / 2), s, n);
+}
+
+constexpr size_t charset_len_join(size_t nLeft, const char* s, size_t n)
+{
+  return nLeft < n / 2 ? nLeft : n / 2 + charset_len(s + n / 2, n - n / 2);
+}
+
+} // namespace detail
+
+//! @class charset xhelpers/sx_charset.h
+//! @brief Set of bytes as a 256-bit table. Sets of string literals and char arrays are built at compile time:
+//!        constexpr charset csVowels("aeiou");
+//!        Multibyte chars of the literal are taken as separate bytes, as std::string::find does.
+//!        Sets of char pointers are built at runtime by add()
+class charset
+{
+public:
+  constexpr charset() : bits{ 0, 0, 0, 0 } {}
+  //! Bytes of the array up to the first zero byte
+  template <size_t N>
+  constexpr charset(const char (&s)[N]) : charset(s, detail::charset_len(s, N)) {}
+  //! Bytes of the zero-terminated string, P is const char* or char*
+  template <class P>
+  charset(const P& s, typename std::enable_if<std::is_pointer<P>::value && std::is_convertible<P, const char*>::value, int>::type = 0) :
+    bits{ 0, 0, 0, 0 }
+  {
+    for (const char* p = s; *p; p++)
+      add(*p);
+  }
+  constexpr charset(const char* s, size_t n) :
+    bits{ detail::charset_word(s, n, 0), detail::charset_word(s, n, 1), detail::charset_word(s, n, 2), detail::charset_word(s, n, 3) } {}
+  charset(const std::string& s) : bits{ 0, 0, 0, 0 } { add(s.data(), s.size()); }
+
+  //! true if the byte is in the set
+  constexpr bool contains(char c) const { return (bits[(unsigned char)c >> 6] >> ((unsigned char)c & 63)) & 1; }
+  constexpr bool operator()(char c) const { return contains(c); }
+
+  //! Union and complement of sets
+  constexpr charset operator|(const charset& cs) const
+  {
+    return charset(bits[0] | cs.bits[0], bits[1] | cs.bits[1], bits[2] | cs.bits[2], bits[3] | cs.bits[3]);
+  }
+  constexpr charset operator~() const { return charset(~bits[0], ~bits[1], ~bits[2], ~bits[3]); }
+
+  void add(char c) { bits[(unsigned char)c >> 6] |= (sx_uint64)1 << ((unsigned char)c & 63); }
+  void add(const char* s, size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+      add(s[i]);
+  }
+
+  //! First byte of [b,e) from the set or e
+  const char* find(const char* b, const char* e) const
+  {
+    while (b < e && !contains(*b))
+      b++;
+    return b;
+  }
+
+  //! First byte of [b,e) not from the set or e
+  const char* find_not(const char* b, const char* e) const
+  {
+    while (b < e && contains(*b))
+      b++;
+    return b;
+  }
+
+protected:
+  constexpr charset(sx_uint64 w0, sx_uint64 w1, sx_uint64 w2, sx_uint64 w3) : bits{ w0, w1, w2, w3 } {}
+
+  sx_uint64 bits[4];
+};
+
+//! @class charmap xhelpers/sx_charset.h
+//! @brief Translation table of 256 bytes, bytes which are not mapped are kept.
+//!        map(from, to) maps from[i] to to[i] with the first occurrence of the byte in from taking effect,
+//!        so translation by the map is the same as change_sym(str, from, to)
+class charmap
+{
+public:
+  charmap() : table(), dom() { reset(); }
+  charmap(const std::string& from, const std::string& to) : table(), dom() { reset(); map(from, to); }
+
+  //! Identity map
+  void reset()
+  {
+    for (int i = 0; i < 256; i++)
+      table[i] = (unsigned char)i;
+    dom = charset();
+  }
+
+  //! Add mappings of from[i] to to[i] for bytes not mapped yet by this call
+  void map(const std::string& from, const std::string& to)
+  {
+    charset done;
+    size_t n = from.size() < to.size() ? from.size() : to.size();
+    for (size_t i = 0; i < n; i++)
+      if (!done.contains(from[i]))
+      {
+        done.add(from[i]);
+        dom.add(from[i]);
+        table[(unsigned char)from[i]] = (unsigned char)to[i];
+      }
+  }
+
+  //! Map which translates as this map followed by next
+  charmap then(const charmap& next) const
+  {
+    charmap m;
+    for (int i = 0; i < 256; i++)
+      m.table[i] = next.table[table[i]];
+    m.dom = dom | next.dom;
+    return m;
+  }
+
+  const charset& domain() const { return dom; }         //!< Bytes given in from strings
+
+  char operator()(char c) const { return (char)table[(unsigned char)c]; }
+  char operator[](char c) const { return (char)table[(unsigned char)c]; }
+
+  //! Translate bytes in place
+  void apply(char* b, char* e) const
+  {
+    for (; b < e; b++)
+      *b = (char)table[(unsigned char)*b];
+  }
+
+protected:
+  unsigned char table[256];
+  charset dom;
+};
+
+} // namespace sx
+
+#endif // SX_CHARSET_H
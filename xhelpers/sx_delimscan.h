@@ -0,0 +1,432 @@
+//!
+//!@file    xhelpers/sx_delimscan.h
+//!@author  Sholomov Dmitry
+//!@date    17.10.2026
+//!@brief   Vectorized search of delimiter characters with runtime SSE4.2/AVX2 dispatch
+//!@note    Define SX_NO_SIMD to build the scalar implementation only
+//!
+
+#ifndef SX_DELIMSCAN_H
+#define SX_DELIMSCAN_H
+
+#include <cstring>
+#include <string>
+
+#if !defined(SX_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86))
+# define SX_SIMD_X86
+#endif
+
+#ifdef SX_SIMD_X86
+# ifdef _MSC_VER
+#  include <intrin.h>
+# endif
+# include <immintrin.h>
+#endif
+
+// SSE2 is always there on x64, on x86 if the compiler targets it. It's used without the runtime dispatch
+#if defined(SX_SIMD_X86) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+# define SX_SIMD_SSE2
+#endif
+
+#if defined(SX_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+# define SX_TARGET(isa) __attribute__((target(isa)))
+#else
+# define SX_TARGET(isa)
+#endif
+
+#ifdef _MSC_VER
+typedef unsigned __int64 sx_uint64;
+#else
+typedef unsigned long long sx_uint64;
+#endif
+
+namespace sx {
+
+//! Index of the lowest set bit, m must be non-zero
+inline int lowest_bit(sx_uint64 m)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+  unsigned long idx; _BitScanForward64(&idx, m); return (int)idx;
+#elif defined(_MSC_VER)
+  unsigned long idx;
+  if ((unsigned long)m) { _BitScanForward(&idx, (unsigned long)m); return (int)idx; }
+  _BitScanForward(&idx, (unsigned long)(m >> 32)); return (int)idx + 32;
+#else
+  return __builtin_ctzll(m);
+#endif
+}
+
+class delim_set;
+
+namespace detail {
+
+typedef void (*delim_masks_fn)(const delim_set& ds, const char* p, size_t nBlocks, sx_uint64* masks);
+typedef const char* (*delim_find_fn)(const delim_set& ds, const char* b, const char* e);
+
+struct delim_kernel
+{
+  delim_masks_fn masks;
+  delim_find_fn  find;
+};
+
+inline const delim_kernel& scalar_delim_kernel();
+inline const delim_kernel& select_delim_kernel();
+
+} // namespace detail
+
+//! @class delim_set xhelpers/sx_delimscan.h
+//! @brief Set of delimiter bytes prepared for fast scanning.
+//!        Up to 16 delimiters are searched with SIMD, larger sets fall back to the lookup table
+class delim_set
+{
+public:
+  static const int max_simd_chars = 16;
+
+  delim_set(const char* delims = "") : nchars(0), kernel(NULL) { assign(delims, delims ? strlen(delims) : 0); }
+  delim_set(const char* delims, size_t n) : nchars(0), kernel(NULL) { assign(delims, n); }
+  delim_set(const std::string& delims) : nchars(0), kernel(NULL) { assign(delims.data(), delims.length()); }
+
+  //! Replace the set by the given delimiter bytes
+  void assign(const char* delims, size_t n)
+  {
+    memset(table, 0, sizeof(table));
+    memset(chars, 0, sizeof(chars));
+    nchars = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+      unsigned char c = (unsigned char)delims[i];
+      if (table[c])
+        continue;
+      table[c] = true;
+      if (nchars < max_simd_chars)
+        chars[nchars] = (char)c;
+      nchars++;
+    }
+    // SIMD kernels take non-empty sets of up to 16 delimiters, other sets use the lookup table
+    kernel = simd() && nchars > 0 ? &detail::select_delim_kernel() : &detail::scalar_delim_kernel();
+  }
+
+  bool contains(char c) const { return table[(unsigned char)c]; }     //!< true if c is a delimiter
+  bool simd() const { return nchars <= max_simd_chars; }              //!< true if the set fits SIMD kernels
+  int size() const { return nchars; }                                 //!< Number of distinct delimiters
+  const char* data() const { return chars; }                          //!< Delimiters (first 16 of them)
+  const bool* lookup() const { return table; }                        //!< 256-entry membership table
+
+  //! Bitmasks of delimiter positions in nBlocks 64-byte blocks starting at p (bit i of masks[k] <-> p[64*k+i])
+  void masks(const char* p, size_t nBlocks, sx_uint64* m) const { kernel->masks(*this, p, nBlocks, m); }
+
+  //! First delimiter in [b,e) or e if there is none
+  const char* find(const char* b, const char* e) const { return kernel->find(*this, b, e); }
+
+  //! First non-delimiter in [b,e) or e if there is none
+  const char* find_not(const char* b, const char* e) const
+  {
+    while (b < e && table[(unsigned char)*b])
+      b++;
+    return b;
+  }
+
+protected:
+  bool table[256];
+  char chars[max_simd_chars];
+  int  nchars;
+  const detail::delim_kernel* kernel;   //!< Kernel chosen for the set by assign()
+};
+
+namespace detail {
+
+inline void delim_masks_scalar(const delim_set& ds, const char* p, size_t nBlocks, sx_uint64* masks)
+{
+  const bool* table = ds.lookup();
+  for (size_t k = 0; k < nBlocks; k++, p += 64)
+  {
+    sx_uint64 m = 0;
+    for (int i = 0; i < 64; i++)
+      m |= (sx_uint64)table[(unsigned char)p[i]] << i;
+    masks[k] = m;
+  }
+}
+
+inline const char* delim_find_scalar(const delim_set& ds, const char* b, const char* e)
+{
+  const bool* table = ds.lookup();
+  while (b < e && !table[(unsigned char)*b])
+    b++;
+  return b;
+}
+
+#ifdef SX_SIMD_X86
+
+SX_TARGET("sse4.2")
+inline void delim_masks_sse42(const delim_set& ds, const char* p, size_t nBlocks, sx_uint64* masks)
+{
+  const __m128i set = _mm_loadu_si128((const __m128i*)ds.data());
+  const int n = ds.size();
+  const int mode = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK;
+  for (size_t k = 0; k < nBlocks; k++, p += 64)
+  {
+    sx_uint64 m = 0;
+    for (int i = 0; i < 4; i++)
+    {
+      __m128i blk = _mm_loadu_si128((const __m128i*)(p + 16*i));
+      m |= (sx_uint64)(unsigned)_mm_cvtsi128_si32(_mm_cmpestrm(set, n, blk, 16, mode)) << (16*i);
+    }
+    masks[k] = m;
+  }
+}
+
+SX_TARGET("sse4.2")
+inline const char* delim_find_sse42(const delim_set& ds, const char* b, const char* e)
+{
+  const __m128i set = _mm_loadu_si128((const __m128i*)ds.data());
+  const int n = ds.size();
+  const int mode = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT;
+  while (e - b >= 16)
+  {
+    __m128i blk = _mm_loadu_si128((const __m128i*)b);
+    int idx = _mm_cmpestri(set, n, blk, 16, mode);
+    if (idx < 16)
+      return b + idx;
+    b += 16;
+  }
+  return delim_find_scalar(ds, b, e);
+}
+
+SX_TARGET("avx2")
+inline unsigned delim_mask32_avx2(const __m256i* set, int n, const char* p)
+{
+  __m256i blk = _mm256_loadu_si256((const __m256i*)p);
+  __m256i acc = _mm256_cmpeq_epi8(blk, set[0]);
+  for (int i = 1; i < n; i++)
+    acc = _mm256_or_si256(acc, _mm256_cmpeq_epi8(blk, set[i]));
+  return (unsigned)_mm256_movemask_epi8(acc);
+}
+
+// The set vectors are built once per call for all blocks
+SX_TARGET("avx2")
+inline void delim_masks_avx2(const delim_set& ds, const char* p, size_t nBlocks, sx_uint64* masks)
+{
+  __m256i set[delim_set::max_simd_chars];
+  const int n = ds.size();
+  for (int i = 0; i < n; i++)
+    set[i] = _mm256_set1_epi8(ds.data()[i]);
+  for (size_t k = 0; k < nBlocks; k++, p += 64)
+    masks[k] = (sx_uint64)delim_mask32_avx2(set, n, p) | ((sx_uint64)delim_mask32_avx2(set, n, p + 32) << 32);
+}
+
+SX_TARGET("avx2")
+inline const char* delim_find_avx2(const delim_set& ds, const char* b, const char* e)
+{
+  __m256i set[delim_set::max_simd_chars];
+  const int n = ds.size();
+  for (int i = 0; i < n; i++)
+    set[i] = _mm256_set1_epi8(ds.data()[i]);
+  while (e - b >= 32)
+  {
+    unsigned m = delim_mask32_avx2(set, n, b);
+    if (m)
+      return b + lowest_bit(m);
+    b += 32;
+  }
+  return delim_find_scalar(ds, b, e);
+}
+
+inline bool cpu_has_sse42()
+{
+#ifdef _MSC_VER
+  int info[4]; __cpuid(info, 1);
+  return (info[2] & (1 << 20)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("sse4.2") != 0;
+#endif
+}
+
+inline bool cpu_has_avx2()
+{
+#ifdef _MSC_VER
+  int info[4]; __cpuid(info, 0);
+  if (info[0] < 7)
+    return false;
+  __cpuid(info, 1);
+  bool osxsave = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0;
+  if (!osxsave || (_xgetbv(0) & 6) != 6)
+    return false;
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#endif // SX_SIMD_X86
+
+inline const delim_kernel& scalar_delim_kernel()
+{
+  static const delim_kernel scalar = { delim_masks_scalar, delim_find_scalar };
+  return scalar;
+}
+
+// SIMD kernel is chosen once on the first use by the CPU features, the sets keep the kernel chosen for them
+inline const delim_kernel& select_delim_kernel()
+{
+#ifdef SX_SIMD_X86
+  static const delim_kernel sse42 = { delim_masks_sse42, delim_find_sse42 };
+  static const delim_kernel avx2 = { delim_masks_avx2, delim_find_avx2 };
+  static const delim_kernel& selected = cpu_has_avx2() ? avx2 : (cpu_has_sse42() ? sse42 : scalar_delim_kernel());
+  return selected;
+#else
+  return scalar_delim_kernel();
+#endif
+}
+
+} // namespace detail
+
+//! @class delim_scanner xhelpers/sx_delimscan.h
+//! @brief Search of the delimiters of [b,e) from left to right. Masks of up to 8 blocks of 64 bytes are computed
+//!        by one kernel call and the delimiters are taken from them by the lowest set bit, so splitting a line
+//!        costs a kernel call per 512 bytes instead of a call per field
+class delim_scanner
+{
+public:
+  delim_scanner(const delim_set& _ds, const char* b, const char* _e) : ds(_ds), base(b), e(_e), nBlocks(0), masks() {}
+
+  //! First delimiter in [p,e) or e if there is none. p may not decrease from call to call
+  const char* find(const char* p)
+  {
+    while (p < e)
+    {
+      size_t off = (size_t)(p - base);
+      if (off >= nBlocks * 64)
+      {
+        fill(p);
+        off = 0;
+      }
+      size_t i = off / 64;
+      sx_uint64 m = masks[i] & (~(sx_uint64)0 << (off % 64));
+      while (!m && ++i < nBlocks)
+        m = masks[i];
+      if (m)
+      {
+        const char* d = base + i * 64 + lowest_bit(m);
+        return d < e ? d : e;
+      }
+      p = base + nBlocks * 64;
+    }
+    return e;
+  }
+
+private:
+  static const size_t batch_blocks = 8;
+
+  //! Masks of the blocks starting at p, the tail shorter than a block is scanned in a zero-padded copy
+  void fill(const char* p)
+  {
+    size_t n = (size_t)(e - p);
+    base = p;
+    nBlocks = n / 64 < batch_blocks ? n / 64 : batch_blocks;
+    if (nBlocks > 0)
+    {
+      ds.masks(p, nBlocks, masks);
+      return;
+    }
+    char tail[64];
+    memcpy(tail, p, n);
+    memset(tail + n, 0, sizeof(tail) - n);
+    ds.masks(tail, 1, masks);
+    nBlocks = 1;
+  }
+
+  const delim_set& ds;
+  const char* base;                     //!< Start of the blocks of masks
+  const char* e;
+  size_t nBlocks;
+  sx_uint64 masks[batch_blocks];
+};
+
+namespace detail {
+
+//! Membership in the delimiters known at compile time as OR of comparisons: no branches and no tables
+template <char... Cs>
+struct static_delims_test;
+
+template <>
+struct static_delims_test<>
+{
+  static bool contains(char) { return false; }
+#ifdef SX_SIMD_SSE2
+  static __m128i eq(__m128i) { return _mm_setzero_si128(); }
+#endif
+};
+
+template <char C, char... Cs>
+struct static_delims_test<C, Cs...>
+{
+  static bool contains(char c) { return (c == C) | static_delims_test<Cs...>::contains(c); }
+#ifdef SX_SIMD_SSE2
+  static __m128i eq(__m128i v) { return _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(C)), static_delims_test<Cs...>::eq(v)); }
+#endif
+};
+
+} // namespace detail
+
+//! @class static_delim_set xhelpers/sx_delimscan.h
+//! @brief Delimiter set fixed at compile time with the interface of delim_set: contains, find, find_not.
+//!        Nothing is built at runtime, the bytes are compared directly, 16 at once with SSE2.
+//!        A single delimiter is searched by memchr
+//!          sx::static_delim_set<'\t', ' '> ds;
+template <char... Cs>
+class static_delim_set
+{
+public:
+  static bool contains(char c) { return detail::static_delims_test<Cs...>::contains(c); }
+
+  //! First delimiter in [b,e) or e if there is none
+  static const char* find(const char* b, const char* e)
+  {
+#ifdef SX_SIMD_SSE2
+    for (; e - b >= 16; b += 16)
+    {
+      unsigned m = (unsigned)_mm_movemask_epi8(detail::static_delims_test<Cs...>::eq(_mm_loadu_si128((const __m128i*)b)));
+      if (m)
+        return b + lowest_bit(m);
+    }
+#endif
+    while (b < e && !contains(*b))
+      b++;
+    return b;
+  }
+
+  //! First non-delimiter in [b,e) or e if there is none
+  static const char* find_not(const char* b, const char* e)
+  {
+    while (b < e && contains(*b))
+      b++;
+    return b;
+  }
+};
+
+template <char C>
+class static_delim_set<C>
+{
+public:
+  static bool contains(char c) { return c == C; }
+
+  static const char* find(const char* b, const char* e)
+  {
+    const void* p = b < e ? memchr(b, C, e - b) : NULL;
+    return p ? static_cast<const char*>(p) : e;
+  }
+
+  static const char* find_not(const char* b, const char* e)
+  {
+    while (b < e && *b == C)
+      b++;
+    return b;
+  }
+};
+
+} // namespace sx
+
+#endif // SX_DELIMSCAN_H
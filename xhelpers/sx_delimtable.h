@@ -0,0 +1,165 @@
+//!
+//!@file    xhelpers/sx_delimtable.h
+//!@author  Sholomov Dmitry
+//!@date    17.10.2026
+//!@brief   Compact columnar table of string fields, alternative to vector<vector<string>>
+//!
+
+#ifndef SX_DELIMTABLE_H
+#define SX_DELIMTABLE_H
+
+#include <vector>
+#include <string>
+#include <cstring>
+
+#include <xhelpers/sx_strview.h>
+
+namespace sx {
+
+//! @class delim_table xhelpers/sx_delimtable.h
+//! @brief Table of string fields with all field bytes in one contiguous arena.
+//!        Fields are addressed by per-column offset and length arrays (struct of arrays),
+//!        rows may have different number of fields. Views returned by accessors are valid
+//!        until the table is modified
+class delim_table
+{
+public:
+  //! @class column_view
+  //! @brief Accessor of a single table column, missing fields are empty
+  class column_view
+  {
+  public:
+    column_view(const delim_table& _tbl, size_t _col) : tbl(_tbl), col(_col) {}
+    size_t size() const { return tbl.rows(); }
+    str_view operator[](size_t row) const { return tbl.at(row, col); }
+  protected:
+    const delim_table& tbl;
+    size_t col;
+  };
+
+  delim_table() : arena(), columns(), widths() {}       //!< Constructors and destructors
+  virtual ~delim_table() {}
+
+  size_t rows() const { return widths.size(); }         //!< Number of rows
+  size_t cols() const { return columns.size(); }        //!< Maximal number of fields in a row
+  size_t row_size(size_t row) const { return widths[row]; } //!< Number of fields in the row
+  size_t bytes() const { return arena.size(); }         //!< Total size of fields data
+  bool empty() const { return widths.empty(); }
+
+  //! Field of the given row and column, empty view for the missing field
+  str_view at(size_t row, size_t col) const
+  {
+    if (col >= columns.size())
+      return str_view();
+    const column_data& c = columns[col];
+    return str_view(arena.empty() ? NULL : &arena[0] + c.offs[row], c.lens[row]);
+  }
+  str_view operator()(size_t row, size_t col) const { return at(row, col); }
+
+  //! Fields of the given row
+  void row(size_t row, std::vector<str_view>& fields) const
+  {
+    fields.resize(widths[row]);
+    for (size_t c = 0; c < fields.size(); c++)
+      fields[c] = at(row, c);
+  }
+
+  //! Fields of the given row as strings
+  void row(size_t row, std::vector<std::string>& fields) const
+  {
+    fields.resize(widths[row]);
+    for (size_t c = 0; c < fields.size(); c++)
+    {
+      str_view f = at(row, c);
+      fields[c].assign(f.data(), f.size());
+    }
+  }
+
+  column_view column(size_t col) const { return column_view(*this, col); } //!< Accessor of the column
+
+  //! Reserve memory for the expected number of rows, columns and data bytes
+  void reserve(size_t nRows, size_t nCols, size_t nBytes)
+  {
+    arena.reserve(nBytes);
+    widths.reserve(nRows);
+    if (columns.size() < nCols)
+      columns.resize(nCols);
+    for (size_t c = 0; c < columns.size(); c++)
+    {
+      columns[c].offs.reserve(nRows);
+      columns[c].lens.reserve(nRows);
+    }
+  }
+
+  void clear()
+  {
+    arena.clear();
+    columns.clear();
+    widths.clear();
+  }
+
+  //! Start a new empty row, its fields are added by add_field
+  void add_row()
+  {
+    for (size_t c = 0; c < columns.size(); c++)
+    {
+      columns[c].offs.push_back(arena.size());
+      columns[c].lens.push_back(0);
+    }
+    widths.push_back(0);
+  }
+
+  //! Append field [b,e) to the last row, the field may be a view of this table
+  void add_field(const char* b, const char* e)
+  {
+    size_t len = e - b;
+    size_t pos = arena.size();
+    size_t row = widths.size() - 1;
+    size_t col = widths[row]++;
+    if (col == columns.size())
+    {
+      columns.push_back(column_data());
+      columns[col].offs.resize(widths.size(), arena.size());
+      columns[col].lens.resize(widths.size(), 0);
+    }
+    columns[col].offs[row] = pos;
+    columns[col].lens[row] = len;
+    if (len == 0)
+      return;
+    if (pos > 0 && b >= &arena[0] && b < &arena[0] + pos)  // the source is moved by the arena growth
+    {
+      size_t src = b - &arena[0];
+      arena.resize(pos + len);
+      memcpy(&arena[pos], &arena[src], len);
+    }
+    else
+      arena.insert(arena.end(), b, e);
+  }
+
+  void operator()(const char* b, const char* e) { add_field(b, e); }   //!< Appender interface for split_delim_line
+
+  //! Append a row of any container of strings or str_views
+  template <class Row>
+  void push_row(const Row& fields)
+  {
+    add_row();
+    for (typename Row::const_iterator it = fields.begin(); it != fields.end(); it++)
+      add_field(it->data(), it->data() + it->size());
+  }
+
+protected:
+  struct column_data
+  {
+    std::vector<size_t>   offs;                         //!< Offsets of the column fields in arena
+    std::vector<size_t>   lens;                         //!< Lengths of the column fields
+    column_data() : offs(), lens() {}
+  };
+
+  std::vector<char>     arena;                          //!< Bytes of all fields in the order of adding
+  std::vector<column_data> columns;                     //!< Per-column offset arrays
+  std::vector<unsigned> widths;                         //!< Number of fields in each row
+};
+
+} // namespace sx
+
+#endif // SX_DELIMTABLE_H
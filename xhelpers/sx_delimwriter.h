@@ -0,0 +1,258 @@
+//!
+//!@file    xhelpers/sx_delimwriter.h
+//!@author  Sholomov Dmitry
+//!@date    17.10.2026
+//!@brief   Buffered writer of delimited rows bypassing the iostream formatting layer
+//!
+
+#ifndef SX_DELIMWRITER_H
+#define SX_DELIMWRITER_H
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstring>
+#include <cerrno>
+
+#ifdef _MSC_VER
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/uio.h>
+#endif
+
+#include <xhelpers/sx_strview.h>
+#include <xhelpers/sx_cast.h>
+
+namespace sx {
+
+//! @class delim_writer xhelpers/sx_delimwriter.h
+//! @brief Writes delimited rows into a large reusable buffer which is flushed to the file by big blocks.
+//!        Numbers are formatted without streams. The output of write_row and of the table operator <<
+//!        is the same as of ofdelimstream
+class delim_writer
+{
+public:
+  //! Creates (truncates) the file, is_open() reports the result
+  delim_writer(const char* filename, const char* dl="\t", const char* dl_line="\n", size_t buf_size=1<<20) :
+    delim(dl), delim_line(dl_line), buf(buf_size > 0 ? buf_size : 1), used(0), fd(-1), os(NULL),
+    bRowStarted(false), bFail(false)
+  {
+#ifdef _MSC_VER
+    fd = _open(filename, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    fd = ::open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+    bFail = fd < 0;
+  }
+
+  //! Writes blocks to the given stream
+  delim_writer(std::ostream& _os, const char* dl="\t", const char* dl_line="\n", size_t buf_size=1<<20) :
+    delim(dl), delim_line(dl_line), buf(buf_size > 0 ? buf_size : 1), used(0), fd(-1), os(&_os),
+    bRowStarted(false), bFail(false)
+  {
+  }
+
+  virtual ~delim_writer() { close(); }
+
+  bool is_open() const { return fd >= 0 || os != NULL; }
+  explicit operator bool() const { return !bFail; }
+
+  // Fields of the current row, delimiter is put before every field except the first one
+  delim_writer& field(const char* p, size_t n)
+  {
+    start_field();
+    append(p, n);
+    return *this;
+  }
+  delim_writer& field(const char* str) { return field(str, strlen(str)); }
+  delim_writer& field(const std::string& str) { return field(str.data(), str.size()); }
+  delim_writer& field(const str_view& str) { return field(str.data(), str.size()); }
+  delim_writer& field(int num) { return field((long long)num); }
+  delim_writer& field(unsigned num) { return field((unsigned long long)num); }
+  delim_writer& field(long num) { return field((long long)num); }
+  delim_writer& field(unsigned long num) { return field((unsigned long long)num); }
+  delim_writer& field(long long num)
+  {
+    start_field();
+    reserve(24);
+    used = format_int(&buf[used], num) - &buf[0];
+    return *this;
+  }
+  delim_writer& field(unsigned long long num)
+  {
+    start_field();
+    reserve(24);
+    used = format_uint(&buf[used], num) - &buf[0];
+    return *this;
+  }
+  delim_writer& field(double num, int precision=17)
+  {
+    start_field();
+    reserve(32);
+    used = format_double(&buf[used], num, precision) - &buf[0];
+    return *this;
+  }
+
+  //! Finish the current row by the line delimiter
+  delim_writer& end_row()
+  {
+    append(delim_line.data(), delim_line.size());
+    bRowStarted = false;
+    return *this;
+  }
+
+  //! Write the whole row of strings, str_views or numbers and the line delimiter
+  template <class Row>
+  delim_writer& write_row(const Row& row)
+  {
+    for (typename Row::const_iterator it = row.begin(); it != row.end(); it++)
+      field(*it);
+    return end_row();
+  }
+
+  //! Write the table rows
+  delim_writer& operator <<(const std::vector<std::vector<std::string> >& tbl)
+  {
+    for (size_t i = 0; i < tbl.size(); i++)
+      write_row(tbl[i]);
+    return *this;
+  }
+
+  //! Write the buffered data to the file
+  bool flush()
+  {
+    bool ok = write_block(used > 0 ? &buf[0] : NULL, used, NULL, 0);
+    used = 0;
+    return ok;
+  }
+
+  //! Flush and close the file
+  bool close()
+  {
+    bool ok = flush();
+    if (fd >= 0)
+    {
+#ifdef _MSC_VER
+      ok = _close(fd) == 0 && ok;
+#else
+      ok = ::close(fd) == 0 && ok;
+#endif
+    }
+    fd = -1;
+    os = NULL;
+    return ok;
+  }
+
+protected:
+  void start_field()
+  {
+    if (bRowStarted)
+      append(delim.data(), delim.size());
+    bRowStarted = true;
+  }
+
+  void reserve(size_t n)
+  {
+    if (buf.size() - used < n)
+      flush();
+    if (buf.size() < n)
+      buf.resize(n);
+  }
+
+  void append(const char* p, size_t n)
+  {
+    if (buf.size() - used >= n)
+    {
+      memcpy(&buf[used], p, n);
+      used += n;
+    }
+    else if (n >= buf.size())
+    {
+      write_block(used > 0 ? &buf[0] : NULL, used, p, n);   // large field goes directly with the buffer
+      used = 0;
+    }
+    else
+    {
+      flush();
+      memcpy(&buf[0], p, n);
+      used = n;
+    }
+  }
+
+  //! Write two blocks in order, by single writev where available
+  bool write_block(const char* p1, size_t n1, const char* p2, size_t n2)
+  {
+    if (bFail)
+      return false;
+    if (os)
+    {
+      if (n1)
+        os->write(p1, n1);
+      if (n2)
+        os->write(p2, n2);
+      bFail = !*os;
+      return !bFail;
+    }
+    if (fd < 0)
+      return n1 + n2 == 0;
+#ifdef _MSC_VER
+    bFail = !write_all(p1, n1) || !write_all(p2, n2);
+#else
+    while (n1 + n2 > 0)
+    {
+      struct iovec iov[2];
+      iov[0].iov_base = const_cast<char*>(p1); iov[0].iov_len = n1;
+      iov[1].iov_base = const_cast<char*>(p2); iov[1].iov_len = n2;
+      ssize_t res = ::writev(fd, n1 ? iov : iov + 1, n1 ? 2 : 1);
+      if (res < 0 && errno == EINTR)
+        continue;
+      if (res <= 0)
+      {
+        bFail = true;
+        break;
+      }
+      size_t done = static_cast<size_t>(res);
+      size_t d1 = done < n1 ? done : n1;
+      p1 += d1; n1 -= d1; done -= d1;
+      p2 += done; n2 -= done;
+    }
+#endif
+    return !bFail;
+  }
+
+#ifdef _MSC_VER
+  bool write_all(const char* p, size_t n)
+  {
+    while (n > 0)
+    {
+      int chunk = n > (1u << 30) ? (1 << 30) : static_cast<int>(n);
+      int res = _write(fd, p, chunk);
+      if (res <= 0)
+        return false;
+      p += res; n -= res;
+    }
+    return true;
+  }
+#endif
+
+  std::string delim;
+  std::string delim_line;
+  std::vector<char> buf;                                //!< Output buffer, reused between flushes
+  size_t used;                                          //!< Number of buffered bytes
+  int fd;                                               //!< Output file descriptor
+  std::ostream* os;                                     //!< Output stream if the writer is created for a stream
+  bool bRowStarted;                                     //!< The current row has fields
+  bool bFail;
+
+private:
+  delim_writer(const delim_writer &);
+  delim_writer &operator=(const delim_writer &);
+};
+
+} // namespace sx
+
+#endif // SX_DELIMWRITER_H
@@ -0,0 +1,758 @@
+//!
+//!@file    xhelpers/sx_format.h
+//!@author  Sholomov Dmitry
+//!@date    17.10.2026
+//!@brief   Type-safe printf-style formatting into growable strings and caller buffers
+//!
+//! The format syntax is the one of printf: %[flags][width][.precision][length]conversion with the flags
+//! "-+ 0#", * for the width and the precision taken from the arguments and the conversions "diuoxXcsfFeEgGaAp".
+//! The length modifiers (h, l, ll, z, ...) are accepted and ignored: arguments are formatted by their
+//! own types, so a mismatch of the conversion and the argument can't read garbage:
+//!   - numbers are converted to the kind of the conversion, %d of 2.7 gives 2 and %f of 2 gives 2.000000,
+//!     a double without an integer value (NaN, inf, out of the long long range) gets the %s form;
+//!   - %s gives the natural form of any argument, the strings are never formatted as numbers;
+//!   - a conversion without its argument is written as is, extra arguments are ignored.
+//! A '%' starting no valid conversion is written as is. The output is never truncated:
+//!   std::string s = sx::format("%s: %5.2f", name, value);
+//!   sx::format_to(line, "%d\t%s\n", id, name);                // appends to line
+//! Formats used many times may be parsed once:
+//!   static const sx::compiled_format fmt("%08x %s");
+//!   sx::format_to(out, fmt, crc, name);
+//! The argument count of a literal format is checked at compile time by the macros:
+//!   std::string s = SX_FORMAT("%d of %d", i, n);
+//!
+
+#ifndef SX_FORMAT_H
+#define SX_FORMAT_H
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+
+#include <xhelpers/sx_cast.h>
+#include <xhelpers/sx_strview.h>
+
+namespace sx {
+
+namespace detail {
+
+//! Argument of the formatting engine, the value with the kind of its type
+struct format_arg
+{
+  enum kind_t { k_none, k_int, k_uint, k_double, k_char, k_str, k_ptr };
+
+  kind_t kind;
+  unsigned bytes;                                       //!< Size of the source integer type, %u %x %o of negatives wrap by it
+  union
+  {
+    long long i;
+    unsigned long long u;
+    double d;
+    const void* p;
+  } v;
+  const char* s;                                        //!< Chars of the string
+  size_t n;
+
+  format_arg() : kind(k_none), bytes(0), v(), s(NULL), n(0) {}
+
+  static format_arg of_int(long long x, unsigned bytes) { format_arg a; a.kind = k_int; a.bytes = bytes; a.v.i = x; return a; }
+  static format_arg of_uint(unsigned long long x, unsigned bytes) { format_arg a; a.kind = k_uint; a.bytes = bytes; a.v.u = x; return a; }
+  static format_arg of_double(double x) { format_arg a; a.kind = k_double; a.v.d = x; return a; }
+  static format_arg of_char(char c) { format_arg a; a.kind = k_char; a.bytes = 1; a.v.i = c; return a; }
+  static format_arg of_str(const char* s, size_t n) { format_arg a; a.kind = k_str; a.s = s; a.n = n; return a; }
+  static format_arg of_ptr(const void* p) { format_arg a; a.kind = k_ptr; a.v.p = p; return a; }
+};
+
+inline format_arg make_format_arg(bool x) { return format_arg::of_int(x ? 1 : 0, sizeof(int)); }
+inline format_arg make_format_arg(char x) { return format_arg::of_char(x); }
+inline format_arg make_format_arg(signed char x) { return format_arg::of_int(x, sizeof(x)); }
+inline format_arg make_format_arg(unsigned char x) { return format_arg::of_uint(x, sizeof(x)); }
+inline format_arg make_format_arg(short x) { return format_arg::of_int(x, sizeof(x)); }
+inline format_arg make_format_arg(unsigned short x) { return format_arg::of_uint(x, sizeof(x)); }
+inline format_arg make_format_arg(int x) { return format_arg::of_int(x, sizeof(x)); }
+inline format_arg make_format_arg(unsigned int x) { return format_arg::of_uint(x, sizeof(x)); }
+inline format_arg make_format_arg(long x) { return format_arg::of_int(x, sizeof(x)); }
+inline format_arg make_format_arg(unsigned long x) { return format_arg::of_uint(x, sizeof(x)); }
+inline format_arg make_format_arg(long long x) { return format_arg::of_int(x, sizeof(x)); }
+inline format_arg make_format_arg(unsigned long long x) { return format_arg::of_uint(x, sizeof(x)); }
+inline format_arg make_format_arg(float x) { return format_arg::of_double(x); }
+inline format_arg make_format_arg(double x) { return format_arg::of_double(x); }
+inline format_arg make_format_arg(long double x) { return format_arg::of_double((double)x); }
+inline format_arg make_format_arg(const char* x) { return x ? format_arg::of_str(x, strlen(x)) : format_arg::of_str("(null)", 6); }
+inline format_arg make_format_arg(const std::string& x) { return format_arg::of_str(x.data(), x.size()); }
+template <class A>
+format_arg make_format_arg(const std::basic_string<char, std::char_traits<char>, A>& x) { return format_arg::of_str(x.data(), x.size()); }
+inline format_arg make_format_arg(str_view x) { return format_arg::of_str(x.data(), x.size()); }
+inline format_arg make_format_arg(const void* x) { return format_arg::of_ptr(x); }
+
+//! Parsed conversion specification
+struct format_spec
+{
+  enum { f_left = 1, f_plus = 2, f_space = 4, f_zero = 8, f_alt = 16 };
+  enum { none = -1, from_arg = -2 };                    //!< Width and precision not given or given by *
+
+  unsigned flags;
+  int width;
+  int precision;
+  char conv;
+
+  format_spec() : flags(0), width(none), precision(none), conv(0) {}
+
+  int args() const { return 1 + (width == from_arg ? 1 : 0) + (precision == from_arg ? 1 : 0); }
+};
+
+constexpr bool format_is_flag(char c) { return c == '-' || c == '+' || c == ' ' || c == '0' || c == '#'; }
+constexpr bool format_is_digit(char c) { return c >= '0' && c <= '9'; }
+constexpr bool format_is_length(char c)
+{
+  return c == 'h' || c == 'l' || c == 'L' || c == 'q' || c == 'j' || c == 'z' || c == 't';
+}
+constexpr bool format_is_conv(char c)
+{
+  return c == 'd' || c == 'i' || c == 'u' || c == 'o' || c == 'x' || c == 'X' || c == 'c' || c == 's' || c == 'p' ||
+         c == 'f' || c == 'F' || c == 'e' || c == 'E' || c == 'g' || c == 'G' || c == 'a' || c == 'A';
+}
+
+//! Parses the specification following '%' in [p,e). Returns the end of the specification or NULL if it's not valid
+inline const char* parse_format_spec(const char* p, const char* e, format_spec& spec)
+{
+  spec = format_spec();
+  for (; p < e && format_is_flag(*p); p++)
+    spec.flags |= *p == '-' ? format_spec::f_left : *p == '+' ? format_spec::f_plus : *p == ' ' ? format_spec::f_space :
+                  *p == '0' ? format_spec::f_zero : format_spec::f_alt;
+  if (p < e && *p == '*')
+  {
+    spec.width = format_spec::from_arg;
+    p++;
+  }
+  else if (p < e && format_is_digit(*p))
+    for (spec.width = 0; p < e && format_is_digit(*p); p++)
+      spec.width = spec.width * 10 + (*p - '0');
+  if (p < e && *p == '.')
+  {
+    p++;
+    if (p < e && *p == '*')
+    {
+      spec.precision = format_spec::from_arg;
+      p++;
+    }
+    else
+      for (spec.precision = 0; p < e && format_is_digit(*p); p++)
+        spec.precision = spec.precision * 10 + (*p - '0');
+  }
+  while (p < e && format_is_length(*p))
+    p++;
+  if (p == e || !format_is_conv(*p))
+    return NULL;
+  spec.conv = *p;
+  return p + 1;
+}
+
+//! Output into a string with any allocator, appended
+template <class String>
+struct format_string_sink
+{
+  String& str;
+  explicit format_string_sink(String& _str) : str(_str) {}
+  void append(const char* p, size_t n) { str.append(p, n); }
+  void fill(char c, size_t n) { str.append(n, c); }
+};
+
+//! Output into the caller buffer: the chars which fit are written, all chars are counted
+struct format_buffer_sink
+{
+  char* buf;
+  size_t size;
+  size_t n;
+  format_buffer_sink(char* _buf, size_t _size) : buf(_buf), size(_size), n(0) {}
+  void append(const char* p, size_t k)
+  {
+    if (k && n < size)                                  // p of an empty view may be NULL
+      memcpy(buf + n, p, size - n < k ? size - n : k);
+    n += k;
+  }
+  void fill(char c, size_t k)
+  {
+    if (k && n < size)
+      memset(buf + n, c, size - n < k ? size - n : k);
+    n += k;
+  }
+
+private:
+  format_buffer_sink(const format_buffer_sink &);                 //!< Конструктор копирования (запрещен)
+  format_buffer_sink &operator=(const format_buffer_sink &);      //!< Оператор присваивания (запрещен)
+};
+
+//! Writes prefix, nZeros zeros and body, padded to the width by spaces or, if bZeroPad, by zeros after the prefix
+template <class Sink>
+void format_padded(Sink& out, const format_spec& spec, bool bZeroPad, const char* prefix, size_t nPrefix,
+  size_t nZeros, const char* body, size_t nBody)
+{
+  size_t len = nPrefix + nZeros + nBody;
+  size_t pad = spec.width > 0 && (size_t)spec.width > len ? (size_t)spec.width - len : 0;
+  if (spec.flags & format_spec::f_left)
+    bZeroPad = false;
+  if (bZeroPad)
+  {
+    nZeros += pad;
+    pad = 0;
+  }
+  if (pad && !(spec.flags & format_spec::f_left))
+    out.fill(' ', pad);
+  out.append(prefix, nPrefix);
+  if (nZeros)
+    out.fill('0', nZeros);
+  out.append(body, nBody);
+  if (pad && (spec.flags & format_spec::f_left))
+    out.fill(' ', pad);
+}
+
+//! Sign of a signed conversion
+inline size_t format_sign(char* prefix, bool bNeg, unsigned flags)
+{
+  if (bNeg)
+    prefix[0] = '-';
+  else if (flags & format_spec::f_plus)
+    prefix[0] = '+';
+  else if (flags & format_spec::f_space)
+    prefix[0] = ' ';
+  else
+    return 0;
+  return 1;
+}
+
+//! Integer conversions d i u o x X p of the magnitude mag
+template <class Sink>
+void format_integer(Sink& out, const format_spec& spec, unsigned long long mag, bool bNeg)
+{
+  char body[24];
+  char* end = body + sizeof(body);
+  char* p = end;
+  const char conv = spec.conv;
+  if (conv == 'd' || conv == 'i' || conv == 'u')
+  {
+    if (mag != 0 || spec.precision != 0)
+    {
+      char tmp[20];
+      size_t n = format_uint(tmp, mag) - tmp;
+      p -= n;
+      memcpy(p, tmp, n);
+    }
+  }
+  else if (conv == 'o')
+  {
+    for (; mag; mag >>= 3)
+      *--p = (char)('0' + (mag & 7));
+  }
+  else
+  {
+    const char* digits = conv == 'X' ? "0123456789ABCDEF" : "0123456789abcdef";
+    for (unsigned long long m = mag; m; m >>= 4)
+      *--p = digits[m & 15];
+  }
+  if (p == end && spec.precision != 0 && conv != 'd' && conv != 'i' && conv != 'u')
+    *--p = '0';                                         // zero, the precision 0 of zero writes nothing
+  size_t nDigits = end - p;
+  size_t nZeros = spec.precision > 0 && (size_t)spec.precision > nDigits ? (size_t)spec.precision - nDigits : 0;
+
+  char prefix[2];
+  size_t nPrefix = 0;
+  if (conv == 'd' || conv == 'i')
+    nPrefix = format_sign(prefix, bNeg, spec.flags);
+  else if (conv == 'p' || ((conv == 'x' || conv == 'X') && (spec.flags & format_spec::f_alt) && mag != 0))
+  {
+    prefix[0] = '0';
+    prefix[1] = conv == 'X' ? 'X' : 'x';
+    nPrefix = 2;
+  }
+  else if (conv == 'o' && (spec.flags & format_spec::f_alt) && nZeros == 0 && (nDigits == 0 || *p != '0'))
+    nZeros = 1;
+  format_padded(out, spec, (spec.flags & format_spec::f_zero) && spec.precision < 0, prefix, nPrefix, nZeros, p, nDigits);
+}
+
+//! Conversion f of moderate numbers by integer arithmetics. Returns false if the rounding of the scaled value
+//! is too close to the tie to be decided by double precision, then printf formats the number
+inline bool format_fixed_digits(double d, int precision, unsigned long long& digits)
+{
+  static const double pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+  if (precision > 15)
+    return false;
+  double scaled = std::fabs(d) * pow10[precision];
+  if (!(scaled < 4503599627370496.0))                   // 2^52, also false for inf and nan
+    return false;
+  double r = std::floor(scaled);
+  double frac = scaled - r;
+  if (std::fabs(frac - 0.5) <= scaled * 2.3e-16)      // the error of the scaling is below 2^-53 of the value
+    return false;
+  digits = (unsigned long long)r + (frac > 0.5 ? 1 : 0);
+  return true;
+}
+
+//! Floating point conversions f F e E g G a A
+template <class Sink>
+void format_floating(Sink& out, const format_spec& spec, double d)
+{
+  int precision = spec.precision < 0 ? 6 : spec.precision;
+  unsigned long long digits;
+  if ((spec.conv == 'f' || spec.conv == 'F') && format_fixed_digits(d, precision, digits))
+  {
+    static const unsigned long long ipow10[] = { 1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+      10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+      10000000000000ULL, 100000000000000ULL, 1000000000000000ULL };
+    char body[48];
+    char* p = format_uint(body, digits / ipow10[precision]);
+    if (precision > 0 || (spec.flags & format_spec::f_alt))
+      *p++ = '.';
+    if (precision > 0)
+    {
+      char tmp[20];
+      unsigned long long f = digits % ipow10[precision];
+      size_t n = format_uint(tmp, f) - tmp;
+      memset(p, '0', precision - n);
+      memcpy(p + precision - n, tmp, n);
+      p += precision;
+    }
+    char prefix[1];
+    size_t nPrefix = format_sign(prefix, std::signbit(d), spec.flags);
+    format_padded(out, spec, (spec.flags & format_spec::f_zero) != 0, prefix, nPrefix, 0, body, p - body);
+    return;
+  }
+
+  char fmt[32];
+  char* f = fmt;
+  *f++ = '%';
+  if (spec.flags & format_spec::f_left) *f++ = '-';
+  if (spec.flags & format_spec::f_plus) *f++ = '+';
+  if (spec.flags & format_spec::f_space) *f++ = ' ';
+  if (spec.flags & format_spec::f_zero) *f++ = '0';
+  if (spec.flags & format_spec::f_alt) *f++ = '#';
+  if (spec.width > 0)
+    f = format_int(f, spec.width);
+  if (spec.precision >= 0)
+  {
+    *f++ = '.';
+    f = format_int(f, spec.precision);
+  }
+  *f++ = spec.conv;
+  *f = 0;
+  char buf[64];
+  int n = snprintf(buf, sizeof(buf), fmt, d);
+  if (n < 0)
+    return;
+  if ((size_t)n < sizeof(buf))
+  {
+    out.append(buf, n);
+    return;
+  }
+  std::vector<char> big(n + 1);
+  snprintf(&big[0], big.size(), fmt, d);
+  out.append(&big[0], n);
+}
+
+//! Chars of the string, the precision of %s limits their number
+template <class Sink>
+void format_chars(Sink& out, const format_spec& spec, const char* s, size_t n)
+{
+  if (spec.conv == 's' && spec.precision >= 0 && (size_t)spec.precision < n)
+    n = spec.precision;
+  format_padded(out, spec, false, "", 0, 0, s, n);
+}
+
+//! Writes the argument by the conversion
+template <class Sink>
+void format_value(Sink& out, format_spec spec, const format_arg& a)
+{
+  char c = spec.conv;
+  const bool bInt = c == 'd' || c == 'i' || c == 'u' || c == 'o' || c == 'x' || c == 'X';
+  const bool bFloat = c == 'f' || c == 'F' || c == 'e' || c == 'E' || c == 'g' || c == 'G' || c == 'a' || c == 'A';
+  switch (a.kind)
+  {
+  case format_arg::k_int:
+  case format_arg::k_uint:
+  case format_arg::k_char:
+    if (c == 'c' || (c == 's' && a.kind == format_arg::k_char))
+    {
+      char ch = (char)a.v.i;
+      return format_chars(out, spec, &ch, 1);
+    }
+    if (bFloat)
+      return format_floating(out, spec, a.kind == format_arg::k_uint ? (double)a.v.u : (double)a.v.i);
+    if (!bInt && c != 'p')
+    {
+      spec.conv = 'd';                                  // natural form of %s
+      spec.precision = format_spec::none;
+    }
+    if (a.kind == format_arg::k_uint)
+      return format_integer(out, spec, a.v.u, false);
+    if (spec.conv == 'd' || spec.conv == 'i')
+      return format_integer(out, spec, a.v.i < 0 ? 0ULL - (unsigned long long)a.v.i : (unsigned long long)a.v.i, a.v.i < 0);
+    return format_integer(out, spec, a.bytes >= 8 ? (unsigned long long)a.v.i :
+                                     (unsigned long long)a.v.i & ((1ULL << (a.bytes * 8)) - 1), false);
+
+  case format_arg::k_double:
+    if (bFloat)
+      return format_floating(out, spec, a.v.d);
+    // NaN, infinities and values out of the long long range have no integer, they get the natural form
+    if ((bInt || c == 'c') && a.v.d >= -9223372036854775808.0 && a.v.d < 9223372036854775808.0)
+    {
+      long long x = (long long)a.v.d;
+      if (c == 'c')
+      {
+        char ch = (char)x;
+        return format_chars(out, spec, &ch, 1);
+      }
+      format_arg ai = format_arg::of_int(x, sizeof(x));
+      return format_value(out, spec, ai);
+    }
+    {
+      char buf[32];                                     // natural form: integers as is, others with the exact round trip
+      char* e = format_double(buf, a.v.d, spec.precision > 0 ? spec.precision : 17);
+      return format_padded(out, spec, false, "", 0, 0, buf, e - buf);
+    }
+
+  case format_arg::k_str:
+    return format_chars(out, spec, a.s, a.n);
+
+  case format_arg::k_ptr:
+    if (!a.v.p)
+      return format_chars(out, format_spec(), "(nil)", 5);
+    spec.conv = 'p';
+    spec.precision = format_spec::none;
+    return format_integer(out, spec, (unsigned long long)(size_t)a.v.p, false);
+
+  default:
+    return;
+  }
+}
+
+//! Integer value of the * argument, none for non-integers
+inline int format_star_value(const format_arg& a)
+{
+  if (a.kind == format_arg::k_int || a.kind == format_arg::k_char)
+    return (int)a.v.i;
+  if (a.kind == format_arg::k_uint)
+    return (int)a.v.u;
+  return format_spec::none;
+}
+
+//! Writes the conversion [b,e) with the arguments starting from iArg, advances iArg.
+//! The text is written as is if the arguments are missing
+template <class Sink>
+void format_conversion(Sink& out, format_spec spec, const char* b, const char* e,
+  const format_arg* args, size_t nArgs, size_t& iArg)
+{
+  if (iArg + spec.args() > nArgs)
+  {
+    out.append(b, e - b);
+    iArg = nArgs;
+    return;
+  }
+  if (spec.width == format_spec::from_arg)
+  {
+    spec.width = format_star_value(args[iArg++]);
+    if (spec.width < 0 && spec.width != format_spec::none)
+    {
+      spec.flags |= format_spec::f_left;                // negative width is the '-' flag
+      spec.width = -spec.width;
+    }
+  }
+  if (spec.precision == format_spec::from_arg)
+  {
+    spec.precision = format_star_value(args[iArg++]);
+    if (spec.precision < 0)
+      spec.precision = format_spec::none;
+  }
+  format_value(out, spec, args[iArg++]);
+}
+
+//! The format interpreter: literal chars are copied, conversions take the arguments in order
+template <class Sink>
+void format_args(Sink& out, str_view fmt, const format_arg* args, size_t nArgs)
+{
+  const char* p = fmt.begin();
+  const char* e = fmt.end();
+  size_t iArg = 0;
+  while (p < e)
+  {
+    const char* q = static_cast<const char*>(memchr(p, '%', e - p));
+    if (!q)
+    {
+      out.append(p, e - p);
+      return;
+    }
+    out.append(p, q - p);
+    if (q + 1 < e && q[1] == '%')
+    {
+      out.append(q, 1);
+      p = q + 2;
+      continue;
+    }
+    format_spec spec;
+    const char* r = parse_format_spec(q + 1, e, spec);
+    if (!r)
+    {
+      out.append(q, 1);                                 // not a conversion, the chars after '%' are literal
+      p = q + 1;
+      continue;
+    }
+    format_conversion(out, spec, q, r, args, nArgs, iArg);
+    p = r;
+  }
+}
+
+} // namespace detail
+
+//! @class compiled_format xhelpers/sx_format.h
+//! @brief Format string parsed once into literal pieces and conversion specifications, formatting by it
+//!        gives the same output as by the source string. The object is immutable, share it between threads freely
+class compiled_format
+{
+public:
+  explicit compiled_format(str_view fmt) : sFmt(fmt.str()), sLiterals(), items(), nArgs(0)
+  {
+    const char* p = sFmt.data();
+    const char* e = p + sFmt.size();
+    item cur;
+    while (p < e)
+    {
+      const char* q = static_cast<const char*>(memchr(p, '%', e - p));
+      if (!q)
+      {
+        sLiterals.append(p, e - p);
+        break;
+      }
+      sLiterals.append(p, q - p);
+      if (q + 1 < e && q[1] == '%')
+      {
+        sLiterals += '%';
+        p = q + 2;
+        continue;
+      }
+      const char* r = detail::parse_format_spec(q + 1, e, cur.spec);
+      if (!r)
+      {
+        sLiterals += '%';
+        p = q + 1;
+        continue;
+      }
+      cur.nLit = sLiterals.size() - cur.lit;
+      cur.bSpec = true;
+      cur.raw = q - sFmt.data();
+      cur.nRaw = r - q;
+      items.push_back(cur);
+      nArgs += cur.spec.args();
+      cur = item();
+      cur.lit = sLiterals.size();
+      p = r;
+    }
+    if (sLiterals.size() > cur.lit)
+    {
+      cur.nLit = sLiterals.size() - cur.lit;
+      items.push_back(cur);
+    }
+  }
+
+  const std::string& str() const { return sFmt; }       //!< Source format
+  size_t args() const { return nArgs; }                 //!< Number of the arguments taken, including * ones
+
+  //! Formats the arguments into the sink of the format engine
+  template <class Sink>
+  void write(Sink& out, const detail::format_arg* args, size_t n) const
+  {
+    size_t iArg = 0;
+    for (size_t i = 0; i < items.size(); i++)
+    {
+      const item& it = items[i];
+      out.append(sLiterals.data() + it.lit, it.nLit);
+      if (it.bSpec)
+        detail::format_conversion(out, it.spec, sFmt.data() + it.raw, sFmt.data() + it.raw + it.nRaw, args, n, iArg);
+    }
+  }
+
+private:
+  struct item
+  {
+    size_t lit, nLit;                                   //!< Literal chars before the conversion in sLiterals
+    bool bSpec;                                         //!< false for the trailing literal
+    detail::format_spec spec;
+    size_t raw, nRaw;                                   //!< Source text of the conversion
+    item() : lit(0), nLit(0), bSpec(false), spec(), raw(0), nRaw(0) {}
+  };
+
+  std::string sFmt;
+  std::string sLiterals;
+  std::vector<item> items;
+  size_t nArgs;
+};
+
+//! Appends the formatted arguments to out
+template <class A, class... Args>
+std::basic_string<char, std::char_traits<char>, A>& format_to(std::basic_string<char, std::char_traits<char>, A>& out,
+  str_view fmt, const Args&... args)
+{
+  typedef std::basic_string<char, std::char_traits<char>, A> string_type;
+  const detail::format_arg a[] = { detail::make_format_arg(args)..., detail::format_arg() };
+  detail::format_string_sink<string_type> sink(out);
+  detail::format_args(sink, fmt, a, sizeof...(Args));
+  return out;
+}
+
+template <class A, class... Args>
+std::basic_string<char, std::char_traits<char>, A>& format_to(std::basic_string<char, std::char_traits<char>, A>& out,
+  const compiled_format& fmt, const Args&... args)
+{
+  typedef std::basic_string<char, std::char_traits<char>, A> string_type;
+  const detail::format_arg a[] = { detail::make_format_arg(args)..., detail::format_arg() };
+  detail::format_string_sink<string_type> sink(out);
+  fmt.write(sink, a, sizeof...(Args));
+  return out;
+}
+
+//! Writes the formatted arguments into buf of size chars as snprintf does: the output is cut to size-1 chars
+//! and zero-terminated (if size>0). Returns the length of the whole output
+template <class... Args>
+size_t format_to(char* buf, size_t size, str_view fmt, const Args&... args)
+{
+  const detail::format_arg a[] = { detail::make_format_arg(args)..., detail::format_arg() };
+  detail::format_buffer_sink sink(buf, size ? size - 1 : 0);
+  detail::format_args(sink, fmt, a, sizeof...(Args));
+  if (size)
+    buf[sink.n < size - 1 ? sink.n : size - 1] = 0;
+  return sink.n;
+}
+
+template <class... Args>
+size_t format_to(char* buf, size_t size, const compiled_format& fmt, const Args&... args)
+{
+  const detail::format_arg a[] = { detail::make_format_arg(args)..., detail::format_arg() };
+  detail::format_buffer_sink sink(buf, size ? size - 1 : 0);
+  fmt.write(sink, a, sizeof...(Args));
+  if (size)
+    buf[sink.n < size - 1 ? sink.n : size - 1] = 0;
+  return sink.n;
+}
+
+//! The formatted arguments as a new string
+template <class... Args>
+std::string format(str_view fmt, const Args&... args)
+{
+  std::string s;
+  format_to(s, fmt, args...);
+  return s;
+}
+
+template <class... Args>
+std::string format(const compiled_format& fmt, const Args&... args)
+{
+  std::string s;
+  format_to(s, fmt, args...);
+  return s;
+}
+
+namespace detail {
+
+// Number of the arguments taken by a literal format, the same parsing as of parse_format_spec by constexpr
+// recursion. The literal is [s,e), r is the position after '%' where the scanning goes on if the specification
+// is not valid. The text between the specifications is skipped by halving, so the recursion depth grows with
+// the number of the specifications and the logarithm of the length, not with the length
+constexpr int format_count_from(const char* s, const char* e);
+
+constexpr bool format_is_stop(char c) { return c == '%' || c == 0; }
+
+constexpr const char* format_find_stop(const char* b, const char* e);
+
+constexpr const char* format_find_stop_right(const char* l, const char* m, const char* e)
+{
+  return l != m ? l : format_find_stop(m, e);
+}
+
+//! First '%' or zero char of [b,e), e if there is none
+constexpr const char* format_find_stop(const char* b, const char* e)
+{
+  return e - b <= 1 ? (b < e && format_is_stop(*b) ? b : e) :
+         format_find_stop_right(format_find_stop(b, b + (e - b) / 2), b + (e - b) / 2, e);
+}
+
+constexpr const char* format_skip_digits(const char* s)
+{
+  return format_is_digit(*s) ? format_skip_digits(s + 1) : s;
+}
+
+constexpr int format_count_length(const char* s, const char* r, int n, const char* e)
+{
+  return format_is_length(*s) ? format_count_length(s + 1, r, n, e) :
+         format_is_conv(*s) ? n + format_count_from(s + 1, e) : format_count_from(r, e);
+}
+
+constexpr int format_count_precision(const char* s, const char* r, int n, const char* e)
+{
+  return *s != '.' ? format_count_length(s, r, n, e) :
+         s[1] == '*' ? format_count_length(s + 2, r, n + 1, e) : format_count_length(format_skip_digits(s + 1), r, n, e);
+}
+
+constexpr int format_count_width(const char* s, const char* r, const char* e)
+{
+  return *s == '*' ? format_count_precision(s + 1, r, 2, e) : format_count_precision(format_skip_digits(s), r, 1, e);
+}
+
+constexpr int format_count_flags(const char* s, const char* r, const char* e)
+{
+  return format_is_flag(*s) ? format_count_flags(s + 1, r, e) : format_count_width(s, r, e);
+}
+
+//! p is the '%' found, the zero char or e
+constexpr int format_count_spec(const char* p, const char* e)
+{
+  return p == e || *p == 0 ? 0 :
+         p[1] == '%' ? format_count_from(p + 2, e) : format_count_flags(p + 1, p + 1, e);
+}
+
+constexpr int format_count_from(const char* s, const char* e)
+{
+  return format_count_spec(format_find_stop(s, e), e);
+}
+
+template <size_t N>
+constexpr int format_arg_count(const char (&s)[N])
+{
+  return format_count_from(s, s + N - 1);
+}
+
+} // namespace detail
+
+//! format and format_to with the argument count checked at compile time, N is the count the format takes.
+//! Used by the SX_FORMAT macros with N computed from the literal format
+template <int N, class... Args>
+std::string format_checked(const char* fmt, const Args&... args)
+{
+  static_assert(N == (int)sizeof...(Args), "the number of arguments doesn't match the format");
+  return format(fmt, args...);
+}
+
+template <int N, class A, class... Args>
+std::basic_string<char, std::char_traits<char>, A>& format_to_checked(std::basic_string<char, std::char_traits<char>, A>& out,
+  const char* fmt, const Args&... args)
+{
+  static_assert(N == (int)sizeof...(Args), "the number of arguments doesn't match the format");
+  return format_to(out, fmt, args...);
+}
+
+} // namespace sx
+
+#define SX_FORMAT_EXPAND(x) x
+#define SX_FORMAT_FIRST_(first, ...) first
+#define SX_FORMAT_FIRST(...) SX_FORMAT_EXPAND(SX_FORMAT_FIRST_(__VA_ARGS__, 0))
+#define SX_FORMAT_SECOND_(first, second, ...) second
+#define SX_FORMAT_SECOND(...) SX_FORMAT_EXPAND(SX_FORMAT_SECOND_(__VA_ARGS__, 0))
+
+//! sx::format with the literal format checked at compile time: SX_FORMAT("%s=%d", name, value)
+#define SX_FORMAT(...) \
+  sx::format_checked<sx::detail::format_arg_count(SX_FORMAT_FIRST(__VA_ARGS__))>(__VA_ARGS__)
+
+//! sx::format_to with the literal format checked at compile time: SX_FORMAT_TO(out, "%s=%d", name, value)
+#define SX_FORMAT_TO(...) \
+  sx::format_to_checked<sx::detail::format_arg_count(SX_FORMAT_SECOND(__VA_ARGS__))>(__VA_ARGS__)
+
+#endif // SX_FORMAT_H
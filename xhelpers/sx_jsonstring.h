@@ -138,8 +138,7 @@ inline json_string json_string::append(const std::string& s_app)
     bPutComma = false;
   if(xstring(*this).erase_sym(" ").ends_with("{"))
     bPutComma = false;
-  *this = bPutComma ? xstring().format("%s, %s", this->c_str(), s_app.c_str()).c_str() : 
-                      xstring().format("%s%s", this->c_str(), s_app.c_str()).c_str();
+  sx::format_to(*this, bPutComma ? ", %s" : "%s", s_app);
   return *this;
 }
 
@@ -160,8 +159,9 @@ inline json_string json_string::debrace()
 inline json_string json_string::embrace()
 {
   using namespace sx;
-  xstring s = json_string(*this).debrace();
-  *this = xstring().format("{ %s }",s.c_str()).c_str();
+  std::string s = json_string(*this).debrace();
+  clear();
+  sx::format_to(*this, "{ %s }", s);
   return *this;
 }
 
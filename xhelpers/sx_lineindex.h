@@ -0,0 +1,74 @@
+//!
+//!@file    xhelpers/sx_lineindex.h
+//!@author  Sholomov Dmitry
+//!@date    17.10.2026
+//!@brief   Index of line start offsets of a text file kept in a sidecar file
+//!
+
+#ifndef SX_LINEINDEX_H
+#define SX_LINEINDEX_H
+
+#include <vector>
+#include <string>
+
+#include <xhelpers/sx_delimscan.h>
+
+namespace sx {
+
+//! @class line_index xhelpers/sx_lineindex.h
+//! @brief Byte offsets of the line starts of a file. Every stride-th offset is stored as is,
+//!        the lines between them are stored as varint-encoded lengths.
+//!        Lines are counted as getline does: the last line may have no delimiter.
+//!        The index is saved into "<file>.lidx" and reused while the file size, mtime
+//!        (in nanoseconds where the file system keeps them) and the hash of its first and last 4K are unchanged:
+//!        a rewrite within the timestamp resolution is caught unless it keeps both ends of the file
+class line_index
+{
+public:
+  line_index();                                         //!< Constructors and destructors
+  virtual ~line_index() {}
+
+  //! Load the sidecar index of the file if it is up to date, otherwise build it and try to save it.
+  //! Returns false if the file can't be read
+  bool open(const char* filename, char delim_line = '\n', unsigned stride = 64);
+
+  //! Build the index by scanning the file
+  bool build(const char* filename, char delim_line = '\n', unsigned stride = 64);
+
+  //! Save the index into idxname / load it, load fails if the index does not match the data file
+  bool save(const char* idxname) const;
+  bool load(const char* idxname, const char* filename, char delim_line = '\n');
+
+  void clear();
+
+  bool is_valid() const { return bValid; }              //!< true if the index is built or loaded
+  size_t rows() const { return nRows; }                 //!< Number of lines of the file
+  sx_uint64 file_size() const { return nFileSize; }     //!< Size of the indexed file
+
+  //! Offset of the row start, false if row >= rows()
+  bool offset(size_t row, sx_uint64& off) const;
+
+  //! Name of the sidecar index file for the data file
+  static std::string sidecar_name(const char* filename) { return std::string(filename) + ".lidx"; }
+
+protected:
+  //! Size and modification time of the file in nanoseconds
+  static bool file_stamp(const char* filename, sx_uint64& size, sx_uint64& mtime);
+  //! Hash of the first and last 4K of the file data
+  static sx_uint64 sample_hash(const char* data, sx_uint64 size);
+
+  std::vector<sx_uint64> checkpoints;                   //!< Offset of every stride-th row
+  std::vector<sx_uint64> block_pos;                     //!< Position of the checkpoint block in deltas
+  std::vector<unsigned char> deltas;                    //!< Varint lengths of the rows following checkpoints
+  size_t nRows;
+  unsigned nStride;
+  char cDelimLine;
+  sx_uint64 nFileSize;
+  sx_uint64 nFileTime;
+  sx_uint64 nFileSample;
+  bool bValid;
+};
+
+} // namespace sx
+
+#endif // SX_LINEINDEX_H
@@ -0,0 +1,49 @@
+//!
+//!@file    xhelpers/sx_mapfile.h
+//!@author  Sholomov Dmitry
+//!@date    17.10.2026
+//!@brief   Read-only memory mapping of a whole file
+//!
+
+#ifndef SX_MAPFILE_H
+#define SX_MAPFILE_H
+
+#include <cstddef>
+
+namespace sx {
+
+//! @class mapped_file xhelpers/sx_mapfile.h
+//! @brief Read-only view of the whole file contents mapped into memory.
+//!        Empty file is opened successfully with size()==0 and data()==NULL
+class mapped_file
+{
+public:
+  mapped_file();                                        //!< Constructors and destructors
+  explicit mapped_file(const char* filename);
+  virtual ~mapped_file();
+
+  bool open(const char* filename);                      //!< Map the file, previous mapping is closed
+  void close();                                         //!< Unmap the file
+
+  bool is_open() const { return bOpen; }                //!< true if the file is mapped
+  const char* data() const { return pData; }            //!< Beginning of the mapped contents
+  size_t size() const { return nSize; }                 //!< Size of the mapped contents in bytes
+
+private:
+  mapped_file(const mapped_file &);                     //!< Конструктор копирования (запрещен)
+  mapped_file &operator=(const mapped_file &);          //!< Оператор присваивания (запрещен)
+
+  const char* pData;
+  size_t nSize;
+  bool bOpen;
+#ifdef _MSC_VER
+  void* hFile;
+  void* hMapping;
+#else
+  int fd;
+#endif
+};
+
+} // namespace sx
+
+#endif // SX_MAPFILE_H
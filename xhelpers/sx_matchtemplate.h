@@ -0,0 +1,225 @@
+//!
+//!@file    xhelpers/sx_matchtemplate.h
+//!@author  Sholomov Dmitry
+//!@date    17.10.2026
+//!@brief   Matching of strings against templates of $-letter #-digit *-any symbol, compiled once and checked in batches
+//!@note    Define SX_NO_SIMD to build the scalar implementation only
+//!
+
+#ifndef SX_MATCHTEMPLATE_H
+#define SX_MATCHTEMPLATE_H
+
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include <xhelpers/sx_str.h>
+
+namespace sx {
+
+//! true if the string matches the template: $ - letter, # - digit, * - any symbol, other chars match themselves.
+//! A template char equal to the string char always matches. Letters and digits are sx::is_letter and sx::is_digit bytes
+inline bool match_template(str_view s, str_view templ)
+{
+  if (s.size() != templ.size())
+    return false;
+  for (size_t i = 0; i < s.size(); i++)
+  {
+    char t = templ[i], c = s[i];
+    if (t == c || t == '*' || (t == '#' && csDigits.contains(c)) || (t == '$' && csLetters.contains(c)))
+      continue;
+    return false;
+  }
+  return true;
+}
+
+namespace detail {
+
+//! Nibble tables of a byte set for the SIMD membership test: bit h of lo_a[l] (lo_b[l]) is set
+//! if the byte h*16+l (128+h*16+l) is in the set, rows are repeated in both 128-bit lanes
+struct class_tables
+{
+  unsigned char lo_a[32], lo_b[32];
+
+  explicit class_tables(const charset& cs) : lo_a(), lo_b()
+  {
+    for (int c = 0; c < 256; c++)
+      if (cs.contains((char)c))
+      {
+        unsigned char* row = c < 128 ? lo_a : lo_b;
+        row[c & 15] |= (unsigned char)(1 << ((c >> 4) & 7));
+        row[16 + (c & 15)] |= (unsigned char)(1 << ((c >> 4) & 7));
+      }
+  }
+};
+
+//! Tables of the template classes: # and $
+struct template_class_tables
+{
+  class_tables digits, letters;
+  template_class_tables() : digits(csDigits), letters(csLetters) {}
+};
+
+inline const template_class_tables& get_template_class_tables()
+{
+  static const template_class_tables tables;
+  return tables;
+}
+
+} // namespace detail
+
+//! @class compiled_template xhelpers/sx_matchtemplate.h
+//! @brief Template of match_template compiled once into per-position byte sets, so a string is checked by one
+//!        table lookup per char. Batch checks of templates up to 32 chars compare the whole string at once
+//!        by SIMD class masks when AVX2 is available. The object is immutable, share it between threads freely
+//!          sx::compiled_template tmpl("$$-####");
+//!          tmpl.match("AB-1234");
+class compiled_template
+{
+public:
+  static const size_t max_simd_length = 32;
+
+  explicit compiled_template(str_view templ) :
+    sTempl(templ.str()), allowed(templ.size()), lit(), mDigit(), mLetter(), mAny()
+  {
+    for (size_t i = 0; i < templ.size(); i++)
+    {
+      char t = templ[i];
+      allowed[i].add(t);
+      if (t == '*')
+        allowed[i] = ~charset();
+      else if (t == '#')
+        allowed[i] = allowed[i] | csDigits;
+      else if (t == '$')
+        allowed[i] = allowed[i] | csLetters;
+    }
+    for (size_t i = 0; i < max_simd_length; i++)
+    {
+      if (i >= templ.size())
+      {
+        mAny[i] = 0xFF;                                 // padding of the string
+        continue;
+      }
+      lit[i] = (unsigned char)templ[i];
+      mAny[i] = templ[i] == '*' ? 0xFF : 0;
+      mDigit[i] = templ[i] == '#' ? 0xFF : 0;
+      mLetter[i] = templ[i] == '$' ? 0xFF : 0;
+    }
+  }
+
+  const std::string& str() const { return sTempl; }    //!< Source template
+  size_t length() const { return allowed.size(); }
+
+  //! true if the string matches the template
+  bool match(str_view s) const
+  {
+    if (s.size() != allowed.size())
+      return false;
+    for (size_t i = 0; i < s.size(); i++)
+      if (!allowed[i].contains(s[i]))
+        return false;
+    return true;
+  }
+
+  bool operator()(str_view s) const { return match(s); }
+
+  //! Checks every string of the column: vector<string>, vector<str_view>, delim_table::column_view or other
+  //! container with size() and operator[] convertible to str_view. res[i] is 1 for the matching strings,
+  //! returns the number of matches
+  template <class Column>
+  size_t match_all(const Column& col, std::vector<char>& res) const
+  {
+    res.resize(col.size());
+#ifdef SX_SIMD_X86
+    if (allowed.size() > 0 && allowed.size() <= max_simd_length && use_simd())
+      return match_all_avx2(col, res);
+#endif
+    size_t nMatch = 0;
+    for (size_t i = 0; i < res.size(); i++)
+    {
+      res[i] = match(col[i]) ? 1 : 0;
+      nMatch += res[i];
+    }
+    return nMatch;
+  }
+
+  //! Number of matching strings of the column
+  template <class Column>
+  size_t count(const Column& col) const
+  {
+    std::vector<char> res;
+    return match_all(col, res);
+  }
+
+protected:
+  static bool use_simd()
+  {
+#ifdef SX_SIMD_X86
+    static const bool bAvx2 = detail::cpu_has_avx2();
+    return bAvx2;
+#else
+    return false;
+#endif
+  }
+
+#ifdef SX_SIMD_X86
+  //! Byte set membership of 32 bytes by two nibble lookups, the high bit of the byte selects the table
+  SX_TARGET("avx2")
+  static __m256i class_mask_avx2(__m256i v, const detail::class_tables& tab)
+  {
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i bitsel = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, (char)128, 1, 2, 4, 8, 16, 32, 64, (char)128,
+                                            1, 2, 4, 8, 16, 32, 64, (char)128, 1, 2, 4, 8, 16, 32, 64, (char)128);
+    __m256i lo = _mm256_and_si256(v, nibble);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+    __m256i rowA = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)tab.lo_a), lo);
+    __m256i rowB = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)tab.lo_b), lo);
+    __m256i row = _mm256_blendv_epi8(rowA, rowB, v);
+    __m256i bit = _mm256_shuffle_epi8(bitsel, hi);
+    return _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit);
+  }
+
+  //! Strings of the template length up to 32 chars are checked at once: a position matches if the char
+  //! equals the template char or the template class of the position contains it
+  template <class Column>
+  SX_TARGET("avx2")
+  size_t match_all_avx2(const Column& col, std::vector<char>& res) const
+  {
+    const detail::template_class_tables& tabs = detail::get_template_class_tables();
+    const __m256i vLit = _mm256_loadu_si256((const __m256i*)lit);
+    const __m256i vAny = _mm256_loadu_si256((const __m256i*)mAny);
+    const __m256i vDigit = _mm256_loadu_si256((const __m256i*)mDigit);
+    const __m256i vLetter = _mm256_loadu_si256((const __m256i*)mLetter);
+    const size_t n = allowed.size();
+    unsigned char buf[max_simd_length];
+    memset(buf, 0, sizeof(buf));
+    size_t nMatch = 0;
+    for (size_t i = 0; i < res.size(); i++)
+    {
+      str_view s(col[i]);
+      res[i] = 0;
+      if (s.size() != n)
+        continue;
+      memcpy(buf, s.data(), n);                         // the bytes after the string are not read, their positions are any
+      __m256i v = _mm256_loadu_si256((const __m256i*)buf);
+      __m256i ok = _mm256_or_si256(_mm256_cmpeq_epi8(v, vLit), vAny);
+      ok = _mm256_or_si256(ok, _mm256_and_si256(class_mask_avx2(v, tabs.digits), vDigit));
+      ok = _mm256_or_si256(ok, _mm256_and_si256(class_mask_avx2(v, tabs.letters), vLetter));
+      res[i] = _mm256_movemask_epi8(ok) == -1 ? 1 : 0;
+      nMatch += res[i];
+    }
+    return nMatch;
+  }
+#endif // SX_SIMD_X86
+
+  std::string sTempl;
+  std::vector<charset> allowed;                         //!< Bytes matching each template position
+  unsigned char lit[max_simd_length];                   //!< Template chars
+  unsigned char mDigit[max_simd_length];                //!< 0xFF for # positions
+  unsigned char mLetter[max_simd_length];               //!< 0xFF for $ positions
+  unsigned char mAny[max_simd_length];                  //!< 0xFF for * positions and after the template end
+};
+
+} // namespace sx
+
+#endif // SX_MATCHTEMPLATE_H
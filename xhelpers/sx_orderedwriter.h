@@ -0,0 +1,75 @@
+//!
+//!@file    xhelpers/sx_orderedwriter.h
+//!@author  Sholomov Dmitry
+//!@date    17.10.2026
+//!@brief   Writer of buffers produced by several threads in their sequence order
+//!
+
+#ifndef SX_ORDEREDWRITER_H
+#define SX_ORDEREDWRITER_H
+
+#include <map>
+#include <string>
+#include <ostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace sx {
+
+//! @class ordered_writer xhelpers/sx_orderedwriter.h
+//! @brief Producer threads submit formatted buffers numbered 0,1,2,..., the committer thread writes them
+//!        to the stream strictly in the sequence order as soon as the next one is available.
+//!        Producers running too far ahead of the committer wait, so memory use is bounded by max_pending buffers
+class ordered_writer
+{
+public:
+  explicit ordered_writer(std::ostream& os, size_t max_pending = 64);
+  virtual ~ordered_writer();                            //!< Finishes writing
+
+  //! Pass the buffer with the sequence number seq, its content is taken by swap. Thread-safe.
+  //! Every number from 0 must be submitted exactly once
+  void submit(size_t seq, std::string& buf);
+
+  //! Write all submitted buffers and stop the committer. Returns false if writing failed
+  bool finish();
+
+  size_t written() const;                               //!< Number of buffers written. Thread-safe
+
+private:
+  ordered_writer(const ordered_writer &);               //!< Конструктор копирования (запрещен)
+  ordered_writer &operator=(const ordered_writer &);    //!< Оператор присваивания (запрещен)
+
+  void committer();                                     //!< Committer thread body
+
+  std::ostream& os;
+  std::map<size_t, std::string> pending;                //!< Submitted buffers waiting for their turn
+  size_t nMaxPending;
+  size_t nNext;                                         //!< Sequence number to be written next
+  bool bFinish;                                         //!< No more buffers will be submitted
+  bool bFail;
+  mutable std::mutex mtx;                               //!< Guards pending, nNext and bFinish
+  std::condition_variable cvCommit;                     //!< Signals the committer: next buffer or finish
+  std::condition_variable cvSpace;                      //!< Signals producers: the window moved
+  std::thread th;
+};
+
+//! Appends rows formatted as odelimstream writes them: fields joined by delim, each row ends by delim_line
+template <class Table>
+void format_rows(std::string& buf, const Table& tbl, size_t beg, size_t end, const std::string& delim, const std::string& delim_line)
+{
+  for (size_t r = beg; r < end; r++)
+  {
+    for (size_t c = 0; c < tbl[r].size(); c++)
+    {
+      if (c > 0)
+        buf += delim;
+      buf += tbl[r][c];
+    }
+    buf += delim_line;
+  }
+}
+
+} // namespace sx
+
+#endif // SX_ORDEREDWRITER_H
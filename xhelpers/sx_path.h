@@ -358,7 +358,7 @@ inline xpath& xpath::makePath(const char* drv, const char* dir, const char* name
 {
 #ifdef WIN32
   if(drv)
-    this->format("%s:/%s/%s.%s", xstring(drv).erase_sym_right(":\\/").c_str(), dir, name, ext);
+    this->format("%s:/%s/%s.%s", xstring(drv).erase_sym_right(":\\/"), dir, name, ext);
   else
     this->format("/%s/%s.%s", dir, name, ext);
 #else
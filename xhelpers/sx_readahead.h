@@ -0,0 +1,61 @@
+//!
+//!@file    xhelpers/sx_readahead.h
+//!@author  Sholomov Dmitry
+//!@date    17.10.2026
+//!@brief   Input stream buffer reading the file ahead by a background thread
+//!
+
+#ifndef SX_READAHEAD_H
+#define SX_READAHEAD_H
+
+#include <cstdio>
+#include <vector>
+#include <streambuf>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace sx {
+
+//! @class readahead_buf xhelpers/sx_readahead.h
+//! @brief Read-only stream buffer with two large buffers: the background thread fills the next buffer
+//!        while the current one is consumed, so disk reads overlap with parsing.
+//!        Seeking restarts the read-ahead from the new position
+class readahead_buf : public std::streambuf
+{
+public:
+  //! Opens the file and starts reading from the offset, is_open() reports the result
+  explicit readahead_buf(const char* filename, std::streamoff offset = 0, size_t buf_size = 1 << 22);
+  virtual ~readahead_buf();
+
+  bool is_open() const { return file != NULL; }         //!< true if the file is opened
+
+protected:
+  virtual int_type underflow();
+  virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which = std::ios_base::in);
+  virtual pos_type seekpos(pos_type pos, std::ios_base::openmode which = std::ios_base::in);
+
+private:
+  readahead_buf(const readahead_buf &);                 //!< Конструктор копирования (запрещен)
+  readahead_buf &operator=(const readahead_buf &);      //!< Оператор присваивания (запрещен)
+
+  void start(std::streamoff offset);                    //!< Position the file and start the reading thread
+  void stop();                                          //!< Stop the reading thread
+  void worker();                                        //!< Reading thread body
+
+  std::FILE* file;
+  std::vector<char> bufs[2];                            //!< Buffers filled in turn by the reading thread
+  size_t filled[2];                                     //!< Number of bytes read into the buffer
+  bool ready[2];                                        //!< Buffer is filled and not consumed yet
+  int cur;                                              //!< Buffer exposed by the get area, -1 for none
+  bool bStop;                                           //!< Reading thread is asked to stop
+  bool bEof;                                            //!< All data are consumed
+  std::streamoff base;                                  //!< File offset of the get area beginning
+  std::mutex mtx;
+  std::condition_variable cv;
+  std::thread th;
+};
+
+} // namespace sx
+
+#endif // SX_READAHEAD_H
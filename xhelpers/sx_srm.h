@@ -18,6 +18,21 @@
 #include <sstream>
 
 #include <cstring>
+#include <algorithm>
+#include <memory>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <xhelpers/sx_strview.h>
+#include <xhelpers/sx_mapfile.h>
+#include <xhelpers/sx_delimscan.h>
+#include <xhelpers/sx_delimtable.h>
+#include <xhelpers/sx_readahead.h>
+#include <xhelpers/sx_lineindex.h>
+#include <xhelpers/sx_orderedwriter.h>
+#include <xhelpers/sx_stringpool.h>
 
 #ifndef _NOEXCEPT
 # define _NOEXCEPT
@@ -30,48 +45,185 @@ namespace sx
 // Classes idelimstream, odelimstream, ifdelimstream, ofdelimstream 
 // can read vector<string> and vector<vector<string>> structures from the stream
 
+// Splits line [beg,end) into fields, out(field_beg, field_end) is called per field. delims is delim_set or static_delim_set.
+// bDelimSingle==false skips the leading delimiters of the line, otherwise every delimiter ends a field
+template <class Delims, class Out>
+inline void split_delim_line(const char* beg, const char* end, const Delims& delims, bool bDelimSingle, Out& out)
+{
+	const char* pCurWdBeg = bDelimSingle ? beg : delims.find_not(beg, end);
+	while (pCurWdBeg < end)
+	{
+		const char* pCurWdEnd = delims.find(pCurWdBeg, end);
+		out(pCurWdBeg, pCurWdEnd);
+		if (pCurWdEnd == end)
+			break;
+		pCurWdBeg = pCurWdEnd+1;
+	}
+}
+
+// The runtime set: the delimiters of the line are taken from the block masks of delim_scanner
+template <class Out>
+inline void split_delim_line(const char* beg, const char* end, const delim_set& delims, bool bDelimSingle, Out& out)
+{
+	delim_scanner scan(delims, beg, end);
+	const char* pCurWdBeg = bDelimSingle ? beg : delims.find_not(beg, end);
+	while (pCurWdBeg < end)
+	{
+		const char* pCurWdEnd = scan.find(pCurWdBeg);
+		out(pCurWdBeg, pCurWdEnd);
+		if (pCurWdEnd == end)
+			break;
+		pCurWdBeg = pCurWdEnd+1;
+	}
+}
+
+struct string_appender
+{
+	std::vector<std::string>& vec;
+	explicit string_appender(std::vector<std::string>& _vec) : vec(_vec) {}
+	void operator()(const char* b, const char* e) { vec.push_back(std::string(b, e)); }
+};
+
+struct view_appender
+{
+	std::vector<str_view>& row;
+	explicit view_appender(std::vector<str_view>& _row) : row(_row) {}
+	void operator()(const char* b, const char* e) { row.push_back(str_view(b, e)); }
+};
+
+struct pool_appender
+{
+	std::vector<pooled_string>& row;
+	string_pool& pool;
+	pool_appender(std::vector<pooled_string>& _row, string_pool& _pool) : row(_row), pool(_pool) {}
+	void operator()(const char* b, const char* e) { row.push_back(pool.intern(str_view(b, e))); }
+};
+
 template <class Stream>
-Stream& read_vec_string(Stream& is,std::vector<std::string>& vec,const char* delim="\t\n\r ",char delim_line='\n', bool bDelimSingle = false)
+Stream& read_vec_string(Stream& is,std::vector<std::string>& vec,const delim_set& delims,char delim_line='\n', bool bDelimSingle = false)
 {  // последний параметр задаёт как рассматривать несколько разделителей подряд, false - как один, true - как несколько
 	std::string str_line;
-	size_t max_col=0;
 	std::vector<std::string> _vec;
 	if(getline(is,str_line,delim_line))	// read next line
 	{
-		char* strbuf=(char*)str_line.c_str();
-		_vec.reserve(max_col);
+		const char* strbuf=str_line.c_str();
+		const char* strend=strbuf+strlen(strbuf);	// the line is processed up to the first zero char
+		string_appender app(_vec);
+		split_delim_line(strbuf, strend, delims, bDelimSingle, app);
+		vec=_vec;
+	}
+	return is;
+}
 
-        char* pCurWdBeg = NULL;  
-        int istrspn = (int) strspn(strbuf,delim);
-        if (!bDelimSingle)
-           pCurWdBeg=strbuf+istrspn; //strspn(strbuf,delim);
-        else
-           pCurWdBeg = strbuf;
+template <class Stream>
+Stream& read_vec_string(Stream& is,std::vector<std::string>& vec,const char* delim="\t\n\r ",char delim_line='\n', bool bDelimSingle = false)
+{
+	return read_vec_string(is,vec,delim_set(delim),delim_line,bDelimSingle);
+}
 
-		char* pCurWdEnd=pCurWdBeg;
-		do
-		{	if(!(pCurWdBeg && *pCurWdBeg))
-				break;
-            
-            istrspn = (int) strspn(pCurWdBeg,delim);
-            if (!bDelimSingle)
-			   pCurWdEnd=pCurWdBeg+strcspn(pCurWdBeg,delim);
-            else
-               pCurWdEnd = strpbrk(pCurWdBeg, delim);
-            if ( !pCurWdEnd )
-               _vec.push_back((std::string)pCurWdBeg);
-			else 
-               _vec.push_back(std::string(pCurWdBeg,pCurWdEnd)); 
-			if(_vec.size()>max_col)
-				max_col=_vec.size();
-            if(pCurWdEnd && *pCurWdEnd)
-			   pCurWdBeg=pCurWdEnd+1;
-		} while(pCurWdBeg && pCurWdEnd && *pCurWdBeg && *pCurWdEnd);
+// Reads the row with the delimiters fixed at compile time, see static_delim_set
+template <class Stream, char... Cs>
+Stream& read_vec_string(Stream& is,std::vector<std::string>& vec,const static_delim_set<Cs...>& delims,char delim_line='\n', bool bDelimSingle = false)
+{
+	std::string str_line;
+	std::vector<std::string> _vec;
+	if(getline(is,str_line,delim_line))
+	{
+		const char* strbuf=str_line.c_str();
+		string_appender app(_vec);
+		split_delim_line(strbuf, strbuf+strlen(strbuf), delims, bDelimSingle, app);
 		vec=_vec;
 	}
 	return is;
 }
 
+// The same with a single field delimiter and the line delimiter as template arguments:
+//   sx::read_vec_string<'\t'>(is,vec);  sx::read_vec_string<';','\r'>(is,vec);
+template <char Delim, char DelimLine='\n', class Stream>
+Stream& read_vec_string(Stream& is,std::vector<std::string>& vec,bool bDelimSingle = false)
+{
+	return read_vec_string(is,vec,static_delim_set<Delim>(),DelimLine,bDelimSingle);
+}
+
+// Reads the row with the fields interned in the pool, repeated values of the stream share one copy
+template <class Stream>
+Stream& read_vec_string(Stream& is,std::vector<pooled_string>& vec,string_pool& pool,const delim_set& delims,char delim_line='\n', bool bDelimSingle = false)
+{
+	std::string str_line;
+	if(getline(is,str_line,delim_line))
+	{
+		const char* strbuf=str_line.c_str();
+		vec.clear();
+		pool_appender app(vec,pool);
+		split_delim_line(strbuf, strbuf+strlen(strbuf), delims, bDelimSingle, app);
+	}
+	return is;
+}
+
+// Buffers kept between read_vec_string calls in the row reusing mode
+struct row_buffer
+{
+	std::string line;                   // line buffer
+	std::string field;                  // unquoted field buffer of the CSV mode
+	std::vector<std::string> spare;     // field strings released by shorter rows, their capacity is kept
+	size_t max_col;                     // column count hint, grows to the widest row read
+	explicit row_buffer(size_t col_hint=0) : line(), field(), spare(), max_col(col_hint) {}
+};
+
+// Appender which assigns fields into the existing strings of the row, so their capacity is reused
+struct string_assigner
+{
+	std::vector<std::string>& vec;
+	row_buffer& buf;
+	size_t n;
+	string_assigner(std::vector<std::string>& _vec, row_buffer& _buf) : vec(_vec), buf(_buf), n(0) {}
+	void operator()(const char* b, const char* e)
+	{
+		if(n==vec.size())
+		{
+			vec.push_back(std::string());
+			if(!buf.spare.empty())
+			{
+				vec.back().swap(buf.spare.back());
+				buf.spare.pop_back();
+			}
+		}
+		vec[n++].assign(b,e);
+	}
+};
+
+// Finishes the row of n fields read in the row reusing mode
+inline void release_row_tail(std::vector<std::string>& vec,row_buffer& buf,size_t n)
+{
+	if(n>buf.max_col)
+		buf.max_col=n;
+	if(buf.spare.capacity()<buf.max_col)
+		buf.spare.reserve(buf.max_col);
+	while(vec.size()>n)	// keep the strings of the unused fields for the next rows
+	{
+		buf.spare.push_back(std::string());
+		buf.spare.back().swap(vec.back());
+		vec.pop_back();
+	}
+}
+
+// Reads the next row into vec reusing vec strings and buf between calls: in the steady state 
+// (rows fit the capacities reached before) reading does no heap allocations
+template <class Stream>
+Stream& read_vec_string(Stream& is,std::vector<std::string>& vec,row_buffer& buf,const delim_set& delims,char delim_line='\n', bool bDelimSingle = false)
+{
+	if(getline(is,buf.line,delim_line))	// read next line
+	{
+		if(vec.capacity()<buf.max_col)
+			vec.reserve(buf.max_col);
+		const char* strbuf=buf.line.c_str();
+		string_assigner app(vec,buf);
+		split_delim_line(strbuf, strbuf+strlen(strbuf), delims, bDelimSingle, app);
+		release_row_tail(vec,buf,app.n);
+	}
+	return is;
+}
+
 template <class Stream>
 Stream& write_vec_string(Stream& os,std::vector<std::string>& vec,const char* delim="\t")
 {
@@ -84,18 +236,596 @@ Stream& write_vec_string(Stream& os,std::vector<std::string>& vec,const char* de
 	return os;
 }
 
+// Reads all rows of the stream into the columnar table, the line buffer is reused between rows
+template <class Stream>
+Stream& read_delim_table(Stream& is,delim_table& tbl,const delim_set& delims,char delim_line='\n', bool bDelimSingle = false)
+{
+	std::string str_line;
+	while(getline(is,str_line,delim_line))
+	{
+		const char* strbuf=str_line.c_str();
+		tbl.add_row();
+		split_delim_line(strbuf, strbuf+strlen(strbuf), delims, bDelimSingle, tbl);
+	}
+	return is;
+}
+
+template <class Stream>
+Stream& write_delim_table(Stream& os,const delim_table& tbl,const char* delim="\t",const char* delim_line="\n")
+{
+	std::streamsize nDelim=strlen(delim), nDelimLine=strlen(delim_line);
+	for(size_t r=0;r<tbl.rows();r++)
+	{
+		for(size_t c=0;c<tbl.row_size(r);c++)
+		{
+			if(c>0)
+				os.write(delim,nDelim);
+			str_view field=tbl.at(r,c);
+			os.write(field.data(),field.size());
+		}
+		os.write(delim_line,nDelimLine);
+	}
+	return os;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// CSV mode (RFC 4180): fields are separated by a single delimiter char, every delimiter ends a field (a trailing 
+// delimiter gives an empty last field), a field may be enclosed in quotes and then contain delimiters, line breaks 
+// and doubled quotes. CR before the LF line end is dropped. Records without quote chars are split by the plain 
+// memchr loop, the quote state machine is used only for the records containing quotes.
+
+struct csv_dialect
+{
+	char delim;
+	char quote;
+	delim_set special;	// chars which make the writer enclose a field in quotes
+	explicit csv_dialect(char _delim=',', char _quote='"') : delim(_delim), quote(_quote), special()
+	{
+		const char chars[]={delim,quote,'\r','\n'};
+		special.assign(chars,sizeof(chars));
+	}
+};
+
+// true if a quoted field is still open at the end of [p,e). bInQuote - [p,e) starts inside a quoted field
+inline bool csv_quote_open(const char* p, const char* e, const csv_dialect& csv, bool bInQuote=false)
+{
+	for(;;)
+	{
+		if(bInQuote || (p<e && *p==csv.quote))
+		{
+			if(!bInQuote)
+				p++;
+			bInQuote=false;
+			for(;;)
+			{
+				const char* q=static_cast<const char*>(memchr(p,csv.quote,e-p));
+				if(!q)
+					return true;
+				p=q+1;
+				if(p<e && *p==csv.quote)
+					p++;
+				else
+					break;
+			}
+		}
+		const char* d=static_cast<const char*>(memchr(p,csv.delim,e-p));
+		if(!d)
+			return false;
+		p=d+1;
+	}
+}
+
+// Splits the complete record [beg,end) into fields, out(field_beg, field_end) is called per field.
+// Unquoted fields point into the record, quoted ones into the field buffer. An empty record has no fields
+template <class Out>
+inline void split_csv_record(const char* beg, const char* end, const csv_dialect& csv, std::string& field, Out& out)
+{
+	if(beg==end)
+		return;
+	const char* p=beg;
+	if(!memchr(beg,csv.quote,end-beg))	// quote-free record
+	{
+		for(;;)
+		{
+			const char* d=static_cast<const char*>(memchr(p,csv.delim,end-p));
+			out(p, d ? d : end);
+			if(!d)
+				return;
+			p=d+1;
+		}
+	}
+	for(;;)
+	{
+		const char* d;
+		if(p<end && *p==csv.quote)
+		{
+			field.clear();
+			for(p++;;)
+			{
+				const char* q=static_cast<const char*>(memchr(p,csv.quote,end-p));
+				if(!q)	// unterminated quote takes the rest of the record
+				{
+					field.append(p,end);
+					p=end;
+					break;
+				}
+				field.append(p,q);
+				p=q+1;
+				if(p<end && *p==csv.quote)
+				{
+					field+=csv.quote;
+					p++;
+				}
+				else
+					break;
+			}
+			d=static_cast<const char*>(memchr(p,csv.delim,end-p));
+			if(!d)
+				d=end;
+			field.append(p,d);	// chars between the closing quote and the delimiter are kept as is
+			out(field.data(), field.data()+field.size());
+		}
+		else
+		{
+			d=static_cast<const char*>(memchr(p,csv.delim,end-p));
+			if(!d)
+				d=end;
+			out(p,d);
+		}
+		if(d==end)
+			return;
+		p=d+1;
+	}
+}
+
+// Reads the next CSV record into line, the record continues over the next lines while a quoted field is open
+template <class Stream>
+bool getline_csv(Stream& is, std::string& line, const csv_dialect& csv, char delim_line='\n')
+{
+	if(!getline(is,line,delim_line))
+		return false;
+	if(memchr(line.data(),csv.quote,line.size()) && csv_quote_open(line.data(),line.data()+line.size(),csv))
+	{
+		std::string next;
+		while(getline(is,next,delim_line))
+		{
+			line+=delim_line;
+			size_t pos=line.size();
+			line+=next;
+			if(!csv_quote_open(line.data()+pos,line.data()+line.size(),csv,true))
+				break;
+		}
+		if(is.eof())	// the record is complete, the stream state is the one of a successful getline
+			is.clear(std::ios::eofbit);
+	}
+	if(delim_line=='\n' && !line.empty() && line[line.size()-1]=='\r')
+		line.erase(line.size()-1);
+	return true;
+}
+
+template <class Stream>
+Stream& read_csv_row(Stream& is,std::vector<std::string>& vec,const csv_dialect& csv,char delim_line='\n')
+{
+	std::string line, field;
+	if(getline_csv(is,line,csv,delim_line))
+	{
+		std::vector<std::string> _vec;
+		string_appender app(_vec);
+		split_csv_record(line.data(), line.data()+line.size(), csv, field, app);
+		vec.swap(_vec);
+	}
+	return is;
+}
+
+// CSV version of read_vec_string in the row reusing mode
+template <class Stream>
+Stream& read_csv_row(Stream& is,std::vector<std::string>& vec,row_buffer& buf,const csv_dialect& csv,char delim_line='\n')
+{
+	if(getline_csv(is,buf.line,csv,delim_line))
+	{
+		if(vec.capacity()<buf.max_col)
+			vec.reserve(buf.max_col);
+		string_assigner app(vec,buf);
+		split_csv_record(buf.line.data(), buf.line.data()+buf.line.size(), csv, buf.field, app);
+		release_row_tail(vec,buf,app.n);
+	}
+	return is;
+}
+
+// CSV version of read_vec_string with the fields interned in the pool
+template <class Stream>
+Stream& read_csv_row(Stream& is,std::vector<pooled_string>& vec,string_pool& pool,const csv_dialect& csv,char delim_line='\n')
+{
+	std::string line, field;
+	if(getline_csv(is,line,csv,delim_line))
+	{
+		vec.clear();
+		pool_appender app(vec,pool);
+		split_csv_record(line.data(), line.data()+line.size(), csv, field, app);
+	}
+	return is;
+}
+
+template <class Stream>
+Stream& read_csv_table(Stream& is,delim_table& tbl,const csv_dialect& csv,char delim_line='\n')
+{
+	std::string line, field;
+	while(getline_csv(is,line,csv,delim_line))
+	{
+		tbl.add_row();
+		split_csv_record(line.data(), line.data()+line.size(), csv, field, tbl);
+	}
+	return is;
+}
+
+// Writes the field enclosing it in quotes only if it contains the delimiter, quote or line break chars
+template <class Stream>
+void write_csv_field(Stream& os,const char* b,const char* e,const csv_dialect& csv)
+{
+	if(csv.special.find(b,e)==e)
+	{
+		os.write(b,e-b);
+		return;
+	}
+	os.put(csv.quote);
+	for(;;)
+	{
+		const char* q=static_cast<const char*>(memchr(b,csv.quote,e-b));
+		if(!q)
+			break;
+		os.write(b,q+1-b);
+		os.put(csv.quote);
+		b=q+1;
+	}
+	os.write(b,e-b);
+	os.put(csv.quote);
+}
+
+// A row of one empty field is written as "", an empty line is read as a row without fields
+template <class Stream>
+void write_csv_empty_row(Stream& os,const csv_dialect& csv)
+{
+	os.put(csv.quote);
+	os.put(csv.quote);
+}
+
+template <class Stream>
+Stream& write_csv_row(Stream& os,const std::vector<std::string>& vec,const csv_dialect& csv)
+{
+	if(vec.size()==1 && vec[0].empty())
+	{
+		write_csv_empty_row(os,csv);
+		return os;
+	}
+	for(size_t i=0;i<vec.size();i++)
+	{
+		if(i>0)
+			os.put(csv.delim);
+		write_csv_field(os,vec[i].data(),vec[i].data()+vec[i].size(),csv);
+	}
+	return os;
+}
+
+template <class Stream>
+Stream& write_csv_table(Stream& os,const delim_table& tbl,const csv_dialect& csv,const char* delim_line="\n")
+{
+	std::streamsize nDelimLine=strlen(delim_line);
+	for(size_t r=0;r<tbl.rows();r++)
+	{
+		size_t n=tbl.row_size(r);
+		if(n==1 && tbl.at(r,0).empty())
+		{
+			write_csv_empty_row(os,csv);
+			n=0;
+		}
+		for(size_t c=0;c<n;c++)
+		{
+			if(c>0)
+				os.put(csv.delim);
+			str_view field=tbl.at(r,c);
+			write_csv_field(os,field.data(),field.data()+field.size(),csv);
+		}
+		os.write(delim_line,nDelimLine);
+	}
+	return os;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Parallel table reading
+
+// Line splitters of read_lines_parallel: split(line_beg, line_end, out)
+struct delim_line_splitter
+{
+	const delim_set& delims;
+	bool bDelimSingle;
+	delim_line_splitter(const delim_set& _delims, bool _bDelimSingle) : delims(_delims), bDelimSingle(_bDelimSingle) {}
+	template <class Out>
+	void operator()(const char* b, const char* e, Out& out) const
+	{
+		const char* z=static_cast<const char*>(memchr(b, 0, e-b));	// the line is processed up to the first zero char
+		split_delim_line(b, z ? z : e, delims, bDelimSingle, out);	// as read_vec_string does
+	}
+};
+
+// Splits lines of a quote-free CSV block
+struct csv_line_splitter
+{
+	const csv_dialect& csv;
+	char delim_line;
+	csv_line_splitter(const csv_dialect& _csv, char _delim_line) : csv(_csv), delim_line(_delim_line) {}
+	template <class Out>
+	void operator()(const char* b, const char* e, Out& out) const
+	{
+		if(delim_line=='\n' && e>b && e[-1]=='\r')
+			e--;
+		std::string field;
+		split_csv_record(b, e, csv, field, out);
+	}
+};
+
+// Number of the ranges for size bytes read by nThreads threads, 0 - OpenMP default (nThreads gets the real count)
+inline int parallel_range_count(size_t size, int& nThreads)
+{
+#ifdef _OPENMP
+	if(nThreads<=0)
+		nThreads=omp_get_max_threads();
+#else
+	nThreads=1;
+#endif
+	const size_t min_range=1<<20;	// small ranges are not worth a thread
+	return (int)std::min<size_t>(size/min_range+1, (size_t)nThreads*4);
+}
+
+// Appends rows of the lines of [b,e) split by the line splitter
+template <class Splitter>
+void read_range_lines(const char* b, const char* e, std::vector<std::vector<std::string> >& rows,
+	const Splitter& split, char delim_line)
+{
+	for(const char* cur=b; cur<e; )
+	{
+		const char* line_end=static_cast<const char*>(memchr(cur, delim_line, e-cur));
+		if(!line_end)
+			line_end=e;
+		rows.push_back(std::vector<std::string>());
+		string_appender app(rows.back());
+		split(cur, line_end, app);
+		cur=line_end+1;
+	}
+}
+
+// Ranges [bounds[i],bounds[i+1]) are read by read(i, range_beg, range_end, rows) using nThreads threads,
+// the rows are appended to tbl in the original order
+template <class RangeReader>
+void read_ranges_parallel(const std::vector<const char*>& bounds, std::vector<std::vector<std::string> >& tbl,
+	const RangeReader& read, int nThreads)
+{
+	int nRanges=(int)bounds.size()-1;
+	std::vector<std::vector<std::vector<std::string> > > parts(nRanges);
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+#else
+	(void)nThreads;
+#endif
+	for(int i=0;i<nRanges;i++)
+		read(i, bounds[i], bounds[i+1], parts[i]);
+
+	size_t nRows=tbl.size();
+	for(int i=0;i<nRanges;i++)
+		nRows+=parts[i].size();
+	tbl.reserve(nRows);
+	for(int i=0;i<nRanges;i++)
+		for(size_t r=0;r<parts[i].size();r++)
+			tbl.push_back(std::move(parts[i][r]));
+}
+
+template <class Splitter>
+struct line_range_reader
+{
+	const Splitter& split;
+	char delim_line;
+	line_range_reader(const Splitter& _split, char _delim_line) : split(_split), delim_line(_delim_line) {}
+	void operator()(int, const char* b, const char* e, std::vector<std::vector<std::string> >& rows) const
+	{
+		read_range_lines(b, e, rows, split, delim_line);
+	}
+};
+
+// Reads all lines of [beg,end) buffer into tbl (rows are appended) using nThreads threads, 0 - OpenMP default.
+// The buffer is split into byte ranges ending at delim_line, each range is tokenized by its own thread,
+// the rows are stitched back in the original order
+template <class Splitter>
+void read_lines_parallel(const char* beg, const char* end, std::vector<std::vector<std::string> >& tbl,
+	const Splitter& split, char delim_line='\n', int nThreads=0)
+{
+	if(beg>=end)
+		return;
+	size_t size=end-beg;
+	int nRanges=parallel_range_count(size, nThreads);
+
+	std::vector<const char*> bounds(nRanges+1, end);
+	bounds[0]=beg;
+	for(int i=1;i<nRanges;i++)
+	{
+		const char* p=std::max(beg+size/nRanges*i, bounds[i-1]);
+		const char* eol=p<end ? static_cast<const char*>(memchr(p, delim_line, end-p)) : NULL;
+		bounds[i]=eol ? eol+1 : end;
+	}
+	read_ranges_parallel(bounds, tbl, line_range_reader<Splitter>(split, delim_line), nThreads);
+}
+
+// End of the CSV record starting at p: past the delim_line closing it or end. The record continues
+// over the next lines while a quoted field is open, see getline_csv
+inline const char* csv_record_end(const char* p, const char* end, const csv_dialect& csv, char delim_line='\n')
+{
+	bool bInQuote=false;
+	for(;;)
+	{
+		const char* eol=static_cast<const char*>(memchr(p, delim_line, end-p));
+		const char* e=eol ? eol : end;
+		if(bInQuote || memchr(p, csv.quote, e-p))
+			bInQuote=csv_quote_open(p, e, csv, bInQuote);
+		if(!bInQuote || !eol)
+			return eol ? eol+1 : end;
+		p=eol+1;
+	}
+}
+
+// Cuts [beg,end) into nRanges ranges of about equal size starting at record starts. Only the records with quotes
+// are walked by the quote state machine, the quote-free lines are skipped by memchr for the quote.
+// quoted[i] - the range i contains quotes and its lines are not all records
+inline void csv_record_bounds(const char* beg, const char* end, const csv_dialect& csv, char delim_line, int nRanges,
+	std::vector<const char*>& bounds, std::vector<char>& quoted)
+{
+	size_t size=end-beg;
+	bounds.assign(1, beg);
+	quoted.clear();
+	for(int i=1;i<=nRanges && bounds.back()<end;i++)
+	{
+		const char* p=bounds.back();
+		const char* target=i<nRanges ? std::max(beg+size/nRanges*i, p) : end;
+		bool bQuoted=false;
+		for(;;)
+		{
+			const char* eol=target<end ? static_cast<const char*>(memchr(target, delim_line, end-target)) : NULL;
+			const char* stop=eol ? eol+1 : end;	// line boundary after target, a record start if [p,stop) is quote-free
+			const char* q=static_cast<const char*>(memchr(p, csv.quote, stop-p));
+			if(!q)
+			{
+				p=stop;
+				break;
+			}
+			bQuoted=true;
+			const char* r=q;	// start of the line with the quote, the lines before it are quote-free records
+			while(r>p && r[-1]!=delim_line)
+				r--;
+			p=csv_record_end(r, end, csv, delim_line);
+			if(p>=target)
+				break;
+		}
+		bounds.push_back(p);
+		quoted.push_back(bQuoted);
+	}
+}
+
+// Reads ranges of csv_record_bounds: quote-free ones by lines, the ones with quotes by records
+struct csv_range_reader
+{
+	const csv_dialect& csv;
+	char delim_line;
+	const std::vector<char>& quoted;
+	csv_range_reader(const csv_dialect& _csv, char _delim_line, const std::vector<char>& _quoted) :
+		csv(_csv), delim_line(_delim_line), quoted(_quoted) {}
+	void operator()(int i, const char* b, const char* e, std::vector<std::vector<std::string> >& rows) const
+	{
+		csv_line_splitter split(csv, delim_line);
+		if(!quoted[i])
+		{
+			read_range_lines(b, e, rows, split, delim_line);
+			return;
+		}
+		for(const char* cur=b; cur<e; )
+		{
+			const char* rec_end=csv_record_end(cur, e, csv, delim_line);
+			rows.push_back(std::vector<std::string>());
+			string_appender app(rows.back());
+			split(cur, rec_end>cur && rec_end[-1]==delim_line ? rec_end-1 : rec_end, app);	// an open quote at the end drops the line break as getline_csv does
+			cur=rec_end;
+		}
+	}
+};
+
+// Reads all CSV records of [beg,end) buffer into tbl (rows are appended) using nThreads threads, 0 - OpenMP default.
+// Quoted fields may contain line breaks, so the range bounds are moved to record starts: ranges without quotes
+// are cut at lines, only the records with quotes are walked by the quote state machine
+inline void read_csv_parallel(const char* beg, const char* end, std::vector<std::vector<std::string> >& tbl,
+	const csv_dialect& csv, char delim_line='\n', int nThreads=0)
+{
+	if(beg>=end)
+		return;
+	int nRanges=parallel_range_count(end-beg, nThreads);
+	std::vector<const char*> bounds;
+	std::vector<char> quoted;
+	csv_record_bounds(beg, end, csv, delim_line, nRanges, bounds, quoted);
+	read_ranges_parallel(bounds, tbl, csv_range_reader(csv, delim_line, quoted), nThreads);
+}
+
+// Reads all rows of [beg,end) buffer into tbl in parallel by read_vec_string rules, see read_lines_parallel
+inline void read_table_parallel(const char* beg, const char* end, std::vector<std::vector<std::string> >& tbl,
+	const delim_set& delims, char delim_line='\n', bool bDelimSingle=false, int nThreads=0)
+{
+	read_lines_parallel(beg, end, tbl, delim_line_splitter(delims, bDelimSingle), delim_line, nThreads);
+}
+
+// Reads the delimited file into tbl in parallel, see read_table_parallel above. Returns false if file can't be opened
+inline bool read_table_parallel(const char* filename, std::vector<std::vector<std::string> >& tbl,
+	const char* delim="\t\n\r ", char delim_line='\n', bool bDelimSingle=false, int nThreads=0)
+{
+	mapped_file file(filename);
+	if(!file.is_open())
+		return false;
+	read_table_parallel(file.data(), file.data()+file.size(), tbl, delim_set(delim), delim_line, bDelimSingle, nThreads);
+	return true;
+}
+
+// Writes the table as odelimstream::operator << does (the output is byte-identical). Rows are formatted 
+// in batches of nBatchRows by nThreads threads (0 - OpenMP default), the committer thread writes batches in order
+inline std::ostream& write_table_parallel(std::ostream& os, const std::vector<std::vector<std::string> >& tbl,
+	const std::string& delim, const std::string& delim_line, int nThreads=0, size_t nBatchRows=4096)
+{
+#ifdef _OPENMP
+	if(nThreads<=0)
+		nThreads=omp_get_max_threads();
+#else
+	nThreads=1;
+#endif
+	if(nBatchRows==0)
+		nBatchRows=1;
+	int nBatches=(int)((tbl.size()+nBatchRows-1)/nBatchRows);
+	ordered_writer writer(os, (size_t)nThreads*4);
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+#endif
+	for(int i=0;i<nBatches;i++)
+	{
+		std::string buf;
+		size_t beg=(size_t)i*nBatchRows;
+		format_rows(buf, tbl, beg, std::min(beg+nBatchRows, tbl.size()), delim, delim_line);
+		writer.submit(i, buf);
+	}
+	writer.finish();
+	return os;
+}
+
 class idelimstream : public std::istream
 {
 	std::string delim;
 	char delim_line;
+	delim_set dset;
+	bool bReuseRow;
+	row_buffer rowbuf;
+	bool bCsv;
+	csv_dialect csv;
 public:
 	idelimstream(std::basic_streambuf<char, std::char_traits<char> > *sb=nullptr, const char* dl="\t\n\r ", char _delim_line='\n') : 
-		std::istream(sb), delim(dl), delim_line(_delim_line)	{ ; } 
+		std::istream(sb), delim(dl), delim_line(_delim_line), dset(dl), bReuseRow(false), rowbuf(), bCsv(false), csv()	{ ; } 
 	virtual ~idelimstream() _NOEXCEPT {;}
 	idelimstream& operator >>(std::vector<std::string>& vec)
 	{
-		return read_vec_string(*this,vec,delim.c_str(),delim_line);
+		if(bCsv)
+			return bReuseRow ? read_csv_row(*this,vec,rowbuf,csv,delim_line) : read_csv_row(*this,vec,csv,delim_line);
+		if(bReuseRow)
+			return read_vec_string(*this,vec,rowbuf,dset,delim_line);
+		return read_vec_string(*this,vec,dset,delim_line);
 	}
+	/// reuse strings of the caller's row and the line buffer between reads
+	void reuse_row(bool bReuse=true) { bReuseRow=bReuse; }
+	/// expected number of columns, grows to the widest row read in the row reusing mode
+	void col_hint(size_t nCols) { rowbuf.max_col=nCols; }
+	size_t col_hint() const { return rowbuf.max_col; }
+	/// RFC 4180 CSV mode: quoted fields, embedded delimiters, line breaks and doubled quotes
+	void set_csv(char _delim=',', char _quote='"') { bCsv=true; csv=csv_dialect(_delim,_quote); }
+	void reset_csv() { bCsv=false; }
+	bool is_csv() const { return bCsv; }
 	idelimstream& operator >>(std::vector<std::vector<std::string> >& tbl)
 	{
 		std::vector<std::string> new_row;
@@ -103,18 +833,32 @@ public:
 			tbl.push_back(new_row);
 		return *this;
 	}
+	idelimstream& operator >>(delim_table& tbl)
+	{
+		if(bCsv)
+			return read_csv_table(*this,tbl,csv,delim_line);
+		return read_delim_table(*this,tbl,dset,delim_line);
+	}
 };
 
 class odelimstream : public std::ostream
 {
 	std::string delim;
 	std::string delim_line;
+	bool bCsv;
+	csv_dialect csv;
 public:
 	odelimstream(std::basic_streambuf<char, std::char_traits<char> > *sb=NULL, const char* dl="\t", const char* dl_line="\n") : 
-		std::ostream(sb), delim(dl), delim_line(dl_line)	{ ; }
+		std::ostream(sb), delim(dl), delim_line(dl_line), bCsv(false), csv()	{ ; }
 	virtual ~odelimstream() _NOEXCEPT { ; }
+	/// RFC 4180 CSV mode: fields with delimiters, quotes or line breaks are quoted
+	void set_csv(char _delim=',', char _quote='"') { bCsv=true; csv=csv_dialect(_delim,_quote); }
+	void reset_csv() { bCsv=false; }
+	bool is_csv() const { return bCsv; }
 	odelimstream& operator <<(std::vector<std::string>& vec)
 	{
+		if(bCsv)
+			return write_csv_row(*this,vec,csv);
 		return write_vec_string(*this,vec,delim.c_str());
 	}
 	odelimstream& operator <<(std::vector<std::vector<std::string> >& tbl)
@@ -123,6 +867,24 @@ public:
 			*this << *it << delim_line;
 		return *this;
 	}
+	/// writing table data formatted by nThreads threads (0 - OpenMP default), the output is the same as of operator <<
+	odelimstream& write_parallel(const std::vector<std::vector<std::string> >& tbl, int nThreads=0, size_t nBatchRows=4096)
+	{
+		if(bCsv)	// CSV quoting is done by the serial writer
+		{
+			for(size_t r=0;r<tbl.size();r++)
+				write_csv_row(*this,tbl[r],csv) << delim_line;
+			return *this;
+		}
+		write_table_parallel(*this,tbl,delim,delim_line,nThreads,nBatchRows);
+		return *this;
+	}
+	odelimstream& operator <<(const delim_table& tbl)
+	{
+		if(bCsv)
+			return write_csv_table(*this,tbl,csv,delim_line.c_str());
+		return write_delim_table(*this,tbl,delim.c_str(),delim_line.c_str());
+	}
 };
 
 // class which can read vector<string>& vec from the stream
@@ -130,15 +892,100 @@ class ifdelimstream : public std::ifstream
 {
 public:
   // construction/destruction
-  ifdelimstream() : delim(""), delim_line('\n'), bDelimSingle(false) {}
-  ifdelimstream(const char* filename, const char* dl="\t\n\r ", const char _delim_line='\n', bool _bDelimSingle=false) :
-    std::ifstream(filename), delim(dl), delim_line(_delim_line), bDelimSingle(_bDelimSingle)	{}
-  virtual ~ifdelimstream() _NOEXCEPT {;}
+  ifdelimstream() : delim(""), delim_line('\n'), bDelimSingle(false), dset(""), filename(), bReuseRow(false), rowbuf(), bCsv(false), csv(), readahead(), lindex(), pool(NULL) {}
+  ifdelimstream(const char* _filename, const char* dl="\t\n\r ", const char _delim_line='\n', bool _bDelimSingle=false) :
+    std::ifstream(_filename), delim(dl), delim_line(_delim_line), bDelimSingle(_bDelimSingle), dset(dl), filename(_filename),
+    bReuseRow(false), rowbuf(), bCsv(false), csv(), readahead(), lindex(), pool(NULL)	{}
+  virtual ~ifdelimstream() _NOEXCEPT
+	{
+		if(readahead)
+			std::istream::rdbuf(std::ifstream::rdbuf());
+	}
+
+  /// opening the file, the name is kept for the memory mapped, read-ahead and indexed reading.
+  /// The read-ahead mode and the line index of the previous file are dropped
+  void open(const char* _filename, std::ios_base::openmode mode=std::ios_base::in)
+	{
+		if(readahead)
+		{
+			std::istream::rdbuf(std::ifstream::rdbuf());
+			readahead.reset();
+		}
+		lindex.clear();
+		filename=_filename;
+		std::ifstream::open(_filename, mode);
+	}
+  void open(const std::string& _filename, std::ios_base::openmode mode=std::ios_base::in) { open(_filename.c_str(), mode); }
 	
   /// reading vector data
   ifdelimstream& operator >>(std::vector<std::string>& vec)
 	{
-		return read_vec_string(*this,vec,delim.c_str(),delim_line, bDelimSingle);
+		if(bCsv)
+			return bReuseRow ? read_csv_row(*this,vec,rowbuf,csv,delim_line) : read_csv_row(*this,vec,csv,delim_line);
+		if(bReuseRow)
+			return read_vec_string(*this,vec,rowbuf,dset,delim_line, bDelimSingle);
+		return read_vec_string(*this,vec,dset,delim_line, bDelimSingle);
+	}
+  /// reading vector data with the fields interned in the pool set by intern_to, fails if it is not set
+  ifdelimstream& operator >>(std::vector<pooled_string>& vec)
+	{
+		if(!pool)
+		{
+			setstate(std::ios::failbit);
+			return *this;
+		}
+		if(bCsv)
+			return read_csv_row(*this,vec,*pool,csv,delim_line);
+		return read_vec_string(*this,vec,*pool,dset,delim_line, bDelimSingle);
+	}
+  /// pool for the categorical columns: equal values of the file are stored once and compared as pointers.
+  /// The pool may be shared by several streams read in parallel
+  void intern_to(string_pool* _pool) { pool=_pool; }
+  string_pool* interned_to() const { return pool; }
+  /// reuse strings of the caller's row and the line buffer between reads,
+  /// in the steady state reading the next row does no heap allocations
+  void reuse_row(bool bReuse=true) { bReuseRow=bReuse; }
+  /// expected number of columns, grows to the widest row read in the row reusing mode
+  void col_hint(size_t nCols) { rowbuf.max_col=nCols; }
+  size_t col_hint() const { return rowbuf.max_col; }
+  /// RFC 4180 CSV mode: quoted fields, embedded delimiters, line breaks and doubled quotes
+  void set_csv(char _delim=',', char _quote='"') { bCsv=true; csv=csv_dialect(_delim,_quote); }
+  void reset_csv() { bCsv=false; }
+  bool is_csv() const { return bCsv; }
+  /// read the file ahead from the current position by a background thread with two buffers of nBufSize bytes,
+  /// so disk reads overlap with tokenizing. Rows read are the same as without read-ahead
+  bool read_ahead(size_t nBufSize=1<<22)
+	{
+		std::streamoff pos = good() ? (std::streamoff)tellg() : -1;
+		if(pos<0)
+			return false;
+		std::unique_ptr<readahead_buf> buf(new readahead_buf(filename.c_str(), pos, nBufSize));
+		if(!buf->is_open())
+			return false;
+		std::istream::rdbuf(buf.get());
+		readahead.swap(buf);
+		return true;
+	}
+  bool is_read_ahead() const { return readahead.get()!=NULL; }
+  /// position the stream at the start of line n (0-based), the next read returns this row.
+  /// The line index is loaded from the "<file>.lidx" sidecar or built and saved there on the first call.
+  /// Rows are lines, so in the CSV mode quoted line breaks are counted as row ends
+  bool seek_row(size_t n)
+	{
+		sx_uint64 off;
+		if(!lindex.is_valid() && !lindex.open(filename.c_str(),delim_line))
+			return false;
+		if(!lindex.offset(n,off))
+			return false;
+		clear();
+		return !seekg((std::streamoff)off).fail();
+	}
+  /// number of lines of the file by the line index, see seek_row
+  size_t row_count()
+	{
+		if(!lindex.is_valid())
+			lindex.open(filename.c_str(),delim_line);
+		return lindex.rows();
 	}
   /// reading table data
   ifdelimstream& operator >>(std::vector<std::vector<std::string> >& tbl)
@@ -148,23 +995,77 @@ public:
 			tbl.push_back(new_row);
 		return *this;
 	}
+  /// reading table data with the fields interned in the pool set by intern_to
+  ifdelimstream& operator >>(std::vector<std::vector<pooled_string> >& tbl)
+	{
+		std::vector<pooled_string> new_row;
+		while(*this >> new_row)
+			tbl.push_back(new_row);
+		return *this;
+	}
+  /// reading table data into the columnar table
+  ifdelimstream& operator >>(delim_table& tbl)
+	{
+		if(bCsv)
+			return read_csv_table(*this,tbl,csv,delim_line);
+		return read_delim_table(*this,tbl,dset,delim_line,bDelimSingle);
+	}
+  /// reading table data from the current position by nThreads threads (0 - OpenMP default),
+  /// the result is the same as of operator >> for table. In the CSV mode the range bounds are moved to record
+  /// starts, only the records with quotes are walked by the quote state machine
+  ifdelimstream& read_parallel(std::vector<std::vector<std::string> >& tbl, int nThreads=0)
+	{
+		std::streamoff pos = good() ? (std::streamoff)tellg() : -1;
+		mapped_file file(filename.c_str());
+		if(pos<0 || !file.is_open() || (size_t)pos>file.size())
+			return *this >> tbl;
+		const char* beg=file.data()+pos;
+		const char* end=file.data()+file.size();
+		if(bCsv)
+			read_csv_parallel(beg, end, tbl, csv, delim_line, nThreads);
+		else
+			read_table_parallel(beg, end, tbl, dset, delim_line, bDelimSingle, nThreads);
+		seekg(0, std::ios::end);
+		setstate(std::ios::eofbit | std::ios::failbit);
+		return *this;
+	}
 
 protected:
 	std::string delim;
 	char delim_line;
   bool bDelimSingle;     // параметр задающий как рассматривать несколько разделителей подряд, false - как один, true - как несколько
+  delim_set dset;        // delimiters prepared for vectorized scanning
+  std::string filename;  // file name for the memory mapped reading
+  bool bReuseRow;        // row reusing mode of operator >> for vector data
+  row_buffer rowbuf;     // buffers kept between reads in the row reusing mode
+  bool bCsv;             // RFC 4180 CSV mode
+  csv_dialect csv;       // CSV delimiter and quote chars
+  std::unique_ptr<readahead_buf> readahead;  // stream buffer of the read-ahead mode
+  line_index lindex;     // line start offsets for seek_row
+  string_pool* pool;     // pool of the interned fields, not owned
 
+private:
+  ifdelimstream(const ifdelimstream &);               //!< Конструктор копирования (запрещен)
+  ifdelimstream &operator=(const ifdelimstream &);    //!< Оператор присваивания (запрещен)
 };
 
 class ofdelimstream : public std::ofstream
 {
 	std::string delim;
 	std::string delim_line;
+	bool bCsv;
+	csv_dialect csv;
 public:
-	ofdelimstream(const char* filename, const char* dl="\t", const char* dl_line="\n") : std::ofstream(filename), delim(dl), delim_line(dl_line) {}
+	ofdelimstream(const char* filename, const char* dl="\t", const char* dl_line="\n") : std::ofstream(filename), delim(dl), delim_line(dl_line), bCsv(false), csv() {}
 	virtual ~ofdelimstream() _NOEXCEPT { ; }
+	/// RFC 4180 CSV mode: fields with delimiters, quotes or line breaks are quoted
+	void set_csv(char _delim=',', char _quote='"') { bCsv=true; csv=csv_dialect(_delim,_quote); }
+	void reset_csv() { bCsv=false; }
+	bool is_csv() const { return bCsv; }
 	ofdelimstream& operator <<(std::vector<std::string>& vec)
 	{
+		if(bCsv)
+			return write_csv_row(*this,vec,csv);
 		return write_vec_string(*this,vec,delim.c_str());
 	}
 	ofdelimstream& operator <<(std::vector<std::vector<std::string> >& tbl)
@@ -173,8 +1074,160 @@ public:
 			*this << *it << delim_line;
 		return *this;
 	}
+	/// writing table data formatted by nThreads threads (0 - OpenMP default), the output is the same as of operator <<
+	ofdelimstream& write_parallel(const std::vector<std::vector<std::string> >& tbl, int nThreads=0, size_t nBatchRows=4096)
+	{
+		if(bCsv)	// CSV quoting is done by the serial writer
+		{
+			for(size_t r=0;r<tbl.size();r++)
+				write_csv_row(*this,tbl[r],csv) << delim_line;
+			return *this;
+		}
+		write_table_parallel(*this,tbl,delim,delim_line,nThreads,nBatchRows);
+		return *this;
+	}
+	ofdelimstream& operator <<(const delim_table& tbl)
+	{
+		if(bCsv)
+			return write_csv_table(*this,tbl,csv,delim_line.c_str());
+		return write_delim_table(*this,tbl,delim.c_str(),delim_line.c_str());
+	}
 };
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class mapped_delim_reader reads rows of a delimited file mapped into memory without copying.
+// Fields are returned as str_view pointing into the mapping and stay valid while the reader is open.
+// Like read_vec_string the line is cut at the first zero char.
+
+class mapped_delim_reader
+{
+public:
+	mapped_delim_reader(const char* filename, const char* dl="\t\n\r ", char _delim_line='\n', bool _bDelimSingle=false) :
+		file(filename), cur(file.data()), delims(dl), delim_line(_delim_line), bDelimSingle(_bDelimSingle), bFail(!file.is_open())
+	{ ; }
+	virtual ~mapped_delim_reader() {;}
+
+	bool is_open() const { return file.is_open(); }
+	explicit operator bool() const { return !bFail; }
+
+	/// reading the next row, false at the end of file
+	bool read(std::vector<str_view>& row)
+	{
+		const char* end = file.data()+file.size();
+		if (bFail || cur >= end)
+			return false;
+		const char* line_end = static_cast<const char*>(memchr(cur, delim_line, end-cur));
+		if (!line_end)
+			line_end = end;
+		row.clear();
+		view_appender app(row);
+		split_delim_line(cur, content_end(cur, line_end), delims, bDelimSingle, app);
+		cur = line_end < end ? line_end+1 : end;
+		return true;
+	}
+
+	/// reading vector data
+	mapped_delim_reader& operator >>(std::vector<str_view>& row)
+	{
+		if (!read(row))
+			bFail = true;
+		return *this;
+	}
+
+	/// reading all remaining rows into the columnar table
+	mapped_delim_reader& operator >>(delim_table& tbl)
+	{
+		const char* end = file.data()+file.size();
+		while (!bFail && cur < end)
+		{
+			const char* line_end = static_cast<const char*>(memchr(cur, delim_line, end-cur));
+			if (!line_end)
+				line_end = end;
+			tbl.add_row();
+			split_delim_line(cur, content_end(cur, line_end), delims, bDelimSingle, tbl);
+			cur = line_end < end ? line_end+1 : end;
+		}
+		bFail = true;
+		return *this;
+	}
+
+	/// start reading from the beginning of the file
+	void rewind()
+	{
+		cur = file.data();
+		bFail = !file.is_open();
+	}
+
+protected:
+	// end of the line content: the first zero char or line_end
+	static const char* content_end(const char* beg, const char* line_end)
+	{
+		const char* zero = static_cast<const char*>(memchr(beg, 0, line_end-beg));
+		return zero ? zero : line_end;
+	}
+
+	mapped_file file;
+	const char* cur;
+	delim_set delims;
+	char delim_line;
+	bool bDelimSingle;     // параметр задающий как рассматривать несколько разделителей подряд, false - как один, true - как несколько
+	bool bFail;
+
+private:
+	mapped_delim_reader(const mapped_delim_reader &);
+	mapped_delim_reader &operator=(const mapped_delim_reader &);
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Streaming visitors: callback(const std::vector<str_view>& row) is called for every row, the row is valid
+// during the call only. Reading stops when callback returns false. Memory use does not depend on the file size.
+// The stream version returns the number of rows passed to the callback, the file versions return false if the file
+// can't be opened and put the number of rows into nRows, so a missing file is not taken for an empty one
+
+template <class Callback>
+size_t for_each_row(std::istream& is, const char* delim, Callback callback, char delim_line='\n', bool bDelimSingle=false)
+{
+	delim_set delims(delim);
+	std::string str_line;
+	std::vector<str_view> row;
+	size_t nRows=0;
+	while(getline(is,str_line,delim_line))
+	{
+		const char* strbuf=str_line.c_str();
+		row.clear();
+		view_appender app(row);
+		split_delim_line(strbuf, strbuf+strlen(strbuf), delims, bDelimSingle, app);
+		nRows++;
+		if(!callback(static_cast<const std::vector<str_view>&>(row)))
+			break;
+	}
+	return nRows;
+}
+
+// The file is memory mapped and is not read into memory as a whole
+template <class Callback>
+bool for_each_row(const char* filename, const char* delim, Callback callback, size_t& nRows, char delim_line='\n', bool bDelimSingle=false)
+{
+	nRows=0;
+	mapped_delim_reader reader(filename, delim, delim_line, bDelimSingle);
+	if(!reader.is_open())
+		return false;
+	std::vector<str_view> row;
+	while(reader.read(row))
+	{
+		nRows++;
+		if(!callback(static_cast<const std::vector<str_view>&>(row)))
+			break;
+	}
+	return true;
+}
+
+template <class Callback>
+bool for_each_row(const std::string& filename, const char* delim, Callback callback, size_t& nRows, char delim_line='\n', bool bDelimSingle=false)
+{
+	return for_each_row(filename.c_str(), delim, callback, nRows, delim_line, bDelimSingle);
+}
+
 } // namespace sx;
 
 #endif
\ No newline at end of file
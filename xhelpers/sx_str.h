@@ -4,10 +4,17 @@
 
 #include <string>
 #include <vector>
+#include <map>
 #include <algorithm>
+#include <iterator>
 #include <stdarg.h>
 
 #include <xhelpers/sx_types.h>
+#include <xhelpers/sx_delimscan.h>
+#include <xhelpers/sx_charset.h>
+#include <xhelpers/sx_strview.h>
+#include <xhelpers/sx_strsearch.h>
+#include <xhelpers/sx_utf8case.h>
 
 #ifdef WIN32
 	#pragma warning(push)
@@ -82,6 +89,76 @@ inline bool symbol_exist(std::basic_string<T>& sString, const std::basic_string<
 	return false;
 }
 
+// Overloads for byte strings use lookup tables: O(n+m) instead of O(n*m) for string of n and symbols of m chars.
+// The strings may have any allocator
+
+template<class A>
+inline void erase_sym_right(std::basic_string<char,std::char_traits<char>,A>& sString,const charset& csSymbols)
+{
+	size_t n=sString.length();
+	while(n>0 && csSymbols.contains(sString[n-1]))
+		n--;
+	sString.erase(n);
+}
+
+template<class A>
+inline void erase_sym_left(std::basic_string<char,std::char_traits<char>,A>& sString,const charset& csSymbols)
+{
+	const char* b=sString.data();
+	sString.erase(0,csSymbols.find_not(b,b+sString.length())-b);
+}
+
+template<class A>
+inline void erase_sym(std::basic_string<char,std::char_traits<char>,A>& sString,const charset& csSymbols)
+{
+	sString.erase(std::remove_if(sString.begin(),sString.end(),csSymbols),sString.end());
+}
+
+template<class A>
+inline void change_sym(std::basic_string<char,std::char_traits<char>,A>& sString,const charmap& cmMap)
+{
+	if(!sString.empty())
+		cmMap.apply(&sString[0],&sString[0]+sString.length());
+}
+
+template<class A>
+inline void change_sym_right(std::basic_string<char,std::char_traits<char>,A>& sString,const charmap& cmMap)
+{
+	for(size_t n=sString.length();n>0 && cmMap.domain().contains(sString[n-1]);n--)
+		sString[n-1]=cmMap(sString[n-1]);
+}
+
+inline bool symbol_exist(str_view sString,const charset& csSymbols)
+{
+	return csSymbols.find(sString.begin(),sString.end())!=sString.end();
+}
+
+inline void erase_sym_right(std::string& sString,const std::string& sSymbols) { erase_sym_right(sString,charset(sSymbols)); }
+inline void erase_sym_left(std::string& sString,const std::string& sSymbols) { erase_sym_left(sString,charset(sSymbols)); }
+inline void erase_sym(std::string& sString,const std::string& sSymbols) { erase_sym(sString,charset(sSymbols)); }
+inline bool symbol_exist(str_view sString,const std::string& sSymbols) { return symbol_exist(sString,charset(sSymbols)); }
+inline bool symbol_exist(std::string& sString,const std::string& sSymbols) { return symbol_exist(str_view(sString),charset(sSymbols)); }
+inline void erase_sym_right(std::string& sString,const char* pSymbols) { erase_sym_right(sString,charset(pSymbols)); }
+inline void erase_sym_left(std::string& sString,const char* pSymbols) { erase_sym_left(sString,charset(pSymbols)); }
+inline void erase_sym(std::string& sString,const char* pSymbols) { erase_sym(sString,charset(pSymbols)); }
+inline bool symbol_exist(str_view sString,const char* pSymbols) { return symbol_exist(sString,charset(pSymbols)); }
+inline bool symbol_exist(str_view sString,str_view sSymbols)
+{
+	charset cs;
+	cs.add(sSymbols.data(),sSymbols.size());
+	return symbol_exist(sString,cs);
+}
+
+inline void change_sym(std::string& sString, const std::string& sSymbolsFrom, const std::string& sSymbolsTo)
+{
+	change_sym(sString,charmap(sSymbolsFrom,sSymbolsTo));
+}
+
+inline void change_sym_right(std::string& sString, const std::string& sSymbolsFrom, const std::string& sSymbolsTo)
+{
+	change_sym_right(sString,charmap(sSymbolsFrom,sSymbolsTo));
+}
+
 const std::string sUpperEng("ABCDEFGHIJKLMNOPQRSTUVWXYZ");
 const std::string sLowerEng("abcdefghijklmnopqrstuvwxyz");
 const std::string sUpperRus("АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ");
@@ -95,6 +172,18 @@ const std::string sCyrConsonant("бвгджзклмнпрстфхцчшщБВГ
 const std::string sLatConsonant("bcdfghjklmnpqrstvwxzBCDFGHJKLMNPQRSTVWXZ");
 const std::string sSeparators(" .,;:-\'\"");
 
+// Built-in sets as compile-time lookup tables, Russian letters are taken as their UTF-8 bytes like the strings above
+constexpr charset csUpperEng("ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+constexpr charset csLowerEng("abcdefghijklmnopqrstuvwxyz");
+constexpr charset csUpperRus("АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ");
+constexpr charset csLowerRus("абвгдеёжзийклмнопрстуфхцчшщъыьэюя");
+constexpr charset csDigits("0123456789");
+constexpr charset csCyrConsonant("бвгджзклмнпрстфхцчшщБВГДЖЗКЛМНПРСТФХЦЧШЩ");
+constexpr charset csLatConsonant("bcdfghjklmnpqrstvwxzBCDFGHJKLMNPQRSTVWXZ");
+constexpr charset csSeparators(" .,;:-\'\"");
+constexpr charset csConsonant = csCyrConsonant | csLatConsonant;
+constexpr charset csLetters = csUpperEng | csLowerEng | csUpperRus | csLowerRus;
+
 const std::wstring wsUpperEng(L"ABCDEFGHIGKLMNOPQRSTUVWXYZ");
 const std::wstring wsLowerEng(L"abcdefghijklmnopqrstuvwxyz");
 const std::wstring wsUpperRus(L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ");
@@ -108,107 +197,289 @@ const std::wstring wsSeparators(L" .,;:-\'\"");
 
 inline bool is_consonant(char c)
 {
-	if(sCyrConsonant.find(c)!=sCyrConsonant.npos)
-		return true;
-	if(sLatConsonant.find(c)!=sLatConsonant.npos)
-		return true;
-	return false;
+	return csConsonant.contains(c);
 }
 
 inline bool is_digit(char c)
 {
-	if(sDigits.find(c)!=sDigits.npos)
-		return true;
-	return false;
+	return csDigits.contains(c);
 }
 
 inline bool is_separator(char c)
 {
-	if(sSeparators.find(c)!=sSeparators.npos)
-		return true;
-	return false;
+	return csSeparators.contains(c);
 }
 
 inline bool is_letter(char c)
 {
-	if(sUpperEng.find(c)!=sUpperEng.npos)
-		return true;
-	if(sLowerEng.find(c)!=sLowerEng.npos)
-		return true;
-	if(sUpperRus.find(c)!=sUpperRus.npos)
-		return true;
-	if(sLowerRus.find(c)!=sLowerRus.npos)
-		return true;
-	return false;
+	return csLetters.contains(c);
 }
 
+// Case of UTF-8 strings: English, Russian and other two-byte letters, see sx_utf8case.h
 inline void lower(std::string& str)
 {
-	sx::change_sym(str,sUpperEng,sLowerEng);
-	sx::change_sym(str,sUpperRus,sLowerRus);
+	sx::utf8_lower(str);
 }
 
 inline void upper(std::string& str)
 {
-	sx::change_sym(str,sLowerEng,sUpperEng);
-	sx::change_sym(str,sLowerRus,sUpperRus);
+	sx::utf8_upper(str);
+}
+
+// Predicates and search on views. The std::string and const char* overloads forward to them and copy nothing
+
+template<class T>
+inline bool begins_with(const basic_str_view<T>& sAll, const basic_str_view<T>& sBegin)
+{
+	return sAll.length()>=sBegin.length() && std::equal(sBegin.begin(),sBegin.end(),sAll.begin());
+}
+
+template<class T>
+inline bool ends_with(const basic_str_view<T>& sAll, const basic_str_view<T>& sEnd)
+{
+	return sAll.length()>=sEnd.length() && std::equal(sEnd.begin(),sEnd.end(),sAll.end()-sEnd.length());
 }
 
 template<class T>
 inline bool begins_with(const std::basic_string<T>& sAll, const std::basic_string<T>& sBegin)
 {
-	return sAll.compare(0,sBegin.length(),sBegin)==0 ? true : false;
+	return begins_with(basic_str_view<T>(sAll),basic_str_view<T>(sBegin));
 }
 
 template<class T>
 inline bool ends_with(const std::basic_string<T>& sAll, const std::basic_string<T>& sEnd)
 {
-	std::string srAll = sAll;
-	std::string srEnd = sEnd;
+	return ends_with(basic_str_view<T>(sAll),basic_str_view<T>(sEnd));
+}
 
-	reverse(srAll.begin(),srAll.end());
-	reverse(srEnd.begin(),srEnd.end());
+inline bool begins_with(str_view sAll,str_view sBegin) { return begins_with<char>(sAll,sBegin); }
+inline bool ends_with(str_view sAll,str_view sEnd) { return ends_with<char>(sAll,sEnd); }
 
-	return srAll.compare(0,srEnd.length(),srEnd)==0 ? true : false;
+inline bool begins_with(const char* pAll,const char* pBegin)
+{
+	return begins_with(str_view(pAll),str_view(pBegin));
 }
 
-inline bool begins_with(const char* pAll,const char* pBegin)
+// true if all chars of the string are from the set, the empty string consists of anything
+inline bool consist_of(str_view sStr,const charset& csSymbols)
+{
+	return csSymbols.find_not(sStr.begin(),sStr.end())==sStr.end();
+}
+
+inline bool consist_of(str_view sStr,const std::string& sSymbols) { return consist_of(sStr,charset(sSymbols)); }
+inline bool consist_of(str_view sStr,const char* pSymbols) { return consist_of(sStr,charset(pSymbols)); }
+inline bool consist_of(str_view sStr,str_view sSymbols)
 {
-	return begins_with<char>( std::string(pAll), std::string(pBegin) );
+	charset cs;
+	cs.add(sSymbols.data(),sSymbols.size());
+	return consist_of(sStr,cs);
 }
 
-inline bool consist_of(const char* pStr,const char* pSymb)
+// Position of the first (last) occurrence of sWhat in sStr or npos
+inline size_t find(str_view sStr,str_view sWhat,size_t pos=0) { return find(sStr.data(),sStr.size(),sWhat.data(),sWhat.size(),pos); }
+inline size_t rfind(str_view sStr,str_view sWhat,size_t pos=str_view::npos) { return rfind(sStr.data(),sStr.size(),sWhat.data(),sWhat.size(),pos); }
+inline bool contains(str_view sStr,str_view sWhat) { return find(sStr,sWhat)!=str_view::npos; }
+
+namespace detail {
+
+// Substring search of the replace functions, byte strings use the sx::find kernel
+template<class T, class Tr, class A>
+inline size_t str_find(const std::basic_string<T,Tr,A>& sStr, const T* p, size_t pos, size_t n) { return sStr.find(p,pos,n); }
+template<class A>
+inline size_t str_find(const std::basic_string<char,std::char_traits<char>,A>& sStr, const char* p, size_t pos, size_t n) { return sx::find(sStr.data(),sStr.length(),p,n,pos); }
+
+} // namespace detail
+
+namespace detail {
+
+// Separator search for the split functions, char strings are scanned by the vectorized delim_set kernel
+template<class T>
+struct sep_finder
+{
+	basic_str_view<T> sSep;
+	explicit sep_finder(const basic_str_view<T>& _sSep) : sSep(_sSep) {}
+	bool contains(T c) const { return sSep.find(c)!=sSep.npos; }
+	const T* find(const T* b, const T* e) const
+	{
+		while(b<e && !contains(*b))
+			b++;
+		return b;
+	}
+};
+
+template<>
+struct sep_finder<char>
+{
+	delim_set ds;
+	explicit sep_finder(const str_view& sSep) : ds(sSep.data(),sSep.size()) {}
+	bool contains(char c) const { return ds.contains(c); }
+	const char* find(const char* b, const char* e) const { return ds.find(b,e); }
+};
+
+} // namespace detail
+
+// Lazy split: the tokens are views into the string found while iterating, nothing is allocated and
+// the string is scanned only as far as the tokens are taken. The tokens are the same as split gives:
+// leading separators give an empty first token, runs of separators after a token are skipped.
+// Iterators refer to the range object, keep it alive while iterating:
+//   for(sx::str_view tok : sx::split_view(line,"\t")) ...
+template<class T>
+class basic_split_range
+{
+public:
+	class iterator
+	{
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef basic_str_view<T> value_type;
+		typedef ptrdiff_t difference_type;
+		typedef const value_type* pointer;
+		typedef const value_type& reference;
+
+		iterator() : sep(0), str_end(0), tok() {}
+		iterator(const detail::sep_finder<T>* _sep, const T* beg, const T* end) :
+			sep(_sep), str_end(end), tok(end,end)
+		{
+			if(beg<end)
+				tok=value_type(beg,sep->find(beg,end));
+		}
+
+		reference operator*() const { return tok; }
+		pointer operator->() const { return &tok; }
+		iterator& operator++() { next(); return *this; }
+		iterator operator++(int) { iterator it(*this); next(); return it; }
+		bool operator==(const iterator& it) const { return tok.data()==it.tok.data(); }
+		bool operator!=(const iterator& it) const { return tok.data()!=it.tok.data(); }
+
+	private:
+		void next()
+		{
+			const T* p=tok.end();
+			if(p!=str_end)
+			{
+				++p;
+				while(p<str_end && sep->contains(*p))
+					p++;
+			}
+			tok=value_type(p,sep->find(p,str_end));
+		}
+
+		const detail::sep_finder<T>* sep;
+		const T* str_end;
+		value_type tok;		// the end iterator has the empty token at str_end
+	};
+	typedef iterator const_iterator;
+
+	basic_split_range(const basic_str_view<T>& _str, const basic_str_view<T>& _sep) : str(_str), sep(_sep) {}
+
+	iterator begin() const { return iterator(&sep,str.begin(),str.end()); }
+	iterator end() const { return iterator(&sep,str.end(),str.end()); }
+	bool empty() const { return str.empty(); }
+
+	// Token n or the empty view if there are no more tokens, the string is scanned up to the token
+	basic_str_view<T> nth(size_t n) const
+	{
+		iterator it=begin(), e=end();
+		for(;it!=e && n>0;n--)
+			++it;
+		return it!=e ? *it : basic_str_view<T>();
+	}
+
+private:
+	basic_str_view<T> str;
+	detail::sep_finder<T> sep;
+};
+
+typedef basic_split_range<char> split_range;
+
+template<class T>
+inline basic_split_range<T> split_view(const basic_str_view<T>& sStr, const basic_str_view<T>& sSep)
 {
-	return 	strspn(pStr,pSymb)==strlen(pStr);
+	return basic_split_range<T>(sStr,sSep);
 }
 
+inline split_range split_view(str_view sStr, str_view sSep) { return split_range(sStr,sSep); }
+
 template<class T>
 inline int split(std::vector< std::basic_string<T> >& vsVec, 
                  const std::basic_string<T>& sStr, 
                  const std::basic_string<T>& sSep
                  )
 {
-    vsVec.clear();
-	typedef typename std::basic_string<T>::const_iterator TBSI;
-	TBSI it_token_beg=sStr.begin();
-	TBSI it_token_end=it_token_beg;
-	while(it_token_beg<sStr.end())
+	typedef basic_split_range<T> TRange;
+	vsVec.clear();
+	TRange range(sStr,sSep);
+	for(typename TRange::iterator it=range.begin();it!=range.end();++it)
+		vsVec.push_back(std::basic_string<T>(it->begin(),it->end()));
+	return (int) vsVec.size();
+}
+
+inline int split(std::vector<std::string>& vsVec, str_view sStr, str_view sSep)
+{
+	vsVec.clear();
+	split_range range(sStr,sSep);
+	for(split_range::iterator it=range.begin();it!=range.end();++it)
+		vsVec.push_back(std::string(it->begin(),it->end()));
+	return (int) vsVec.size();
+}
+
+// split to views into sStr, the vector is cleared but keeps its capacity, so reusing it for many
+// strings allocates nothing after the first few
+template<class T>
+inline int split(std::vector< basic_str_view<T> >& vsVec,
+                 const basic_str_view<T>& sStr,
+                 const basic_str_view<T>& sSep
+                 )
+{
+	typedef basic_split_range<T> TRange;
+	vsVec.clear();
+	TRange range(sStr,sSep);
+	for(typename TRange::iterator it=range.begin();it!=range.end();++it)
+		vsVec.push_back(*it);
+	return (int) vsVec.size();
+}
+
+inline int split(std::vector<str_view>& vsVec, str_view sStr, str_view sSep) { return split<char>(vsVec,sStr,sSep); }
+
+namespace detail {
+
+// Tokens of split by the delimiter set of static_delim_set or delim_set type
+template<class Token, class Delims>
+inline int split_by(std::vector<Token>& vsVec, str_view sStr, const Delims& delims)
+{
+	vsVec.clear();
+	const char* p=sStr.begin();
+	const char* e=sStr.end();
+	while(p<e)
 	{
-		it_token_end=it_token_beg;
-		while(it_token_end<sStr.end() && sSep.find(*it_token_end)==sSep.npos)
-			it_token_end++;
-		vsVec.push_back(std::string(it_token_beg,it_token_end));
-	    it_token_beg = it_token_end;
-        if (it_token_beg != sStr.end())
-        {
-            ++it_token_beg;
-		while(it_token_beg<sStr.end() && sSep.find(*it_token_beg)!=sSep.npos)
-			it_token_beg++;
-        }
+		const char* q=delims.find(p,e);
+		vsVec.push_back(Token(p,q));
+		if(q==e)
+			break;
+		p=delims.find_not(q+1,e);
 	}
 	return (int) vsVec.size();
 }
 
+} // namespace detail
+
+// split by the separators fixed at compile time, the tokens are the same as split with the separator string gives:
+//   sx::split<'\t'>(vsVec,sLine);  sx::split<' ',','>(vsVec,sLine);
+// One separator is searched by memchr, several are compared directly without building a table
+template<char... Seps>
+inline int split(std::vector<std::string>& vsVec, str_view sStr)
+{
+	static_assert(sizeof...(Seps)>0, "no separators");
+	return detail::split_by(vsVec,sStr,static_delim_set<Seps...>());
+}
+
+template<char... Seps>
+inline int split(std::vector<str_view>& vsVec, str_view sStr)
+{
+	static_assert(sizeof...(Seps)>0, "no separators");
+	return detail::split_by(vsVec,sStr,static_delim_set<Seps...>());
+}
+
 // split string with token positions information
 template<class T>
 inline int split_ex(std::vector< std::basic_string<T> >& vsVec,
@@ -217,37 +488,46 @@ inline int split_ex(std::vector< std::basic_string<T> >& vsVec,
                     std::vector< std::pair<int,int> >& vsPositions
                     )
 {
-  using namespace std;
+	typedef basic_split_range<T> TRange;
 	vsVec.clear();
-	typedef typename basic_string<T>::const_iterator TBSI;
-	TBSI it_token_beg=sStr.begin();
-	TBSI it_token_end=it_token_beg;
-	while(it_token_beg<sStr.end())
+	TRange range(sStr,sSep);
+	for(typename TRange::iterator it=range.begin();it!=range.end();++it)
 	{
-		it_token_end=it_token_beg;
-		while(it_token_end<sStr.end() && sSep.find(*it_token_end)==sSep.npos)
-			it_token_end++;
-		vsVec.push_back(string(it_token_beg,it_token_end));
-		pair<int,int> ppos;
-		ppos.first = it_token_beg-sStr.begin();
-		ppos.second = it_token_end-sStr.begin();
-		vsPositions.push_back(ppos);
-		it_token_beg = it_token_end;
-		if (it_token_beg != sStr.end())
-		{
-			++it_token_beg;
-			while(it_token_beg<sStr.end() && sSep.find(*it_token_beg)!=sSep.npos)
-				it_token_beg++;
-		}
+		vsVec.push_back(std::basic_string<T>(it->begin(),it->end()));
+		vsPositions.push_back(std::make_pair((int)(it->begin()-sStr.data()),(int)(it->end()-sStr.data())));
 	}
 	return (int) vsVec.size();
 }
 
-// join strings with separator
+// split to views with token positions, the positions are offsets of the views in sStr
 template<class T>
-inline int join(std::basic_string<T> &vsStr,
-  const std::vector<std::basic_string<T> > &sVec,
-  const std::basic_string<T> &sSep)
+inline int split_ex(std::vector< basic_str_view<T> >& vsVec,
+                    const basic_str_view<T>& sStr,
+                    const basic_str_view<T>& sSep,
+                    std::vector< std::pair<int,int> >& vsPositions
+                    )
+{
+	typedef basic_split_range<T> TRange;
+	vsVec.clear();
+	TRange range(sStr,sSep);
+	for(typename TRange::iterator it=range.begin();it!=range.end();++it)
+	{
+		vsVec.push_back(*it);
+		vsPositions.push_back(std::make_pair((int)(it->begin()-sStr.data()),(int)(it->end()-sStr.data())));
+	}
+	return (int) vsVec.size();
+}
+
+inline int split_ex(std::vector<str_view>& vsVec, str_view sStr, str_view sSep, std::vector< std::pair<int,int> >& vsPositions)
+{
+	return split_ex<char>(vsVec,sStr,sSep,vsPositions);
+}
+
+// join strings with separator
+template<class T, class Tr, class A>
+inline int join(std::basic_string<T,Tr,A> &vsStr,
+  const std::vector<std::basic_string<T,Tr,A> > &sVec,
+  const std::basic_string<T,Tr,A> &sSep)
 {
   vsStr.clear();
 
@@ -256,27 +536,38 @@ inline int join(std::basic_string<T> &vsStr,
     vsStr = sVec[0];
     for (size_t i = 1; i < sVec.size(); ++i)
     {
-      vsStr += sSep + sVec[i];
+      vsStr += sSep;
+      vsStr += sVec[i];
     }
   }
 
   return (int) vsStr.size();
 }
 
+// The replace functions taking views don't copy the patterns, the views must not point into sStr.
+// The strings may have any allocator, the new buffers are taken from it
+template<class T, class Tr, class A>
+inline void replace_first(std::basic_string<T,Tr,A>& sStr, const basic_str_view<T>& sFrom, const basic_str_view<T>& sTo)
+{
+	typename std::basic_string<T,Tr,A>::size_type pos=0;
+	if((pos=detail::str_find(sStr,sFrom.data(),0,sFrom.length()))!=sStr.npos)
+		sStr.replace(pos,sFrom.length(),sTo.data(),sTo.length());
+}
+
 template<class T>
 inline void replace_first(std::basic_string<T>& sStr, const std::basic_string<T>& sFrom, const std::basic_string<T>& sTo)
 {
-	typename std::basic_string<T>::size_type pos=0;
-	if((pos=sStr.find(sFrom))!=sStr.npos)
-		sStr.replace(sStr.begin()+pos,sStr.begin()+pos+sFrom.length(),sTo.begin(),sTo.end());
+	replace_first(sStr,basic_str_view<T>(sFrom),basic_str_view<T>(sTo));
 }
 
+inline void replace_first(std::string& sStr, str_view sFrom, str_view sTo) { replace_first<char>(sStr,sFrom,sTo); }
+
 template<class T>
 inline void replace_all(std::basic_string<T>& sStr, const std::basic_string<T>& sFrom, const std::basic_string<T>& sTo)
 {
 	typename std::basic_string<T>::size_type pos=0;
 	std::basic_string<T> sPrev=sStr;
-	while((pos=sStr.find(sFrom))!=sStr.npos)
+	while((pos=detail::str_find(sStr,sFrom.data(),0,sFrom.length()))!=sStr.npos)
 	{
 		sStr.replace(sStr.begin()+pos,sStr.begin()+pos+sFrom.length(),sTo.begin(),sTo.end());
 		if(sStr==sPrev)
@@ -285,37 +576,277 @@ inline void replace_all(std::basic_string<T>& sStr, const std::basic_string<T>&
 	}
 }
 
+// Replaces all non-overlapping occurrences of sFrom found left to right in a single pass, the inserted sTo
+// is not searched again. The result is built in place if sTo is not longer than sFrom, otherwise in one
+// allocation of the precomputed size. Differs from replace_all only where a replacement forms a new match.
+// Returns the number of replacements
+template<class T, class Tr, class A>
+inline size_t replace_all_once(std::basic_string<T,Tr,A>& sStr, const basic_str_view<T>& sFrom, const basic_str_view<T>& sTo)
+{
+	typedef typename std::basic_string<T,Tr,A>::size_type TBSS;
+	const TBSS nFrom=sFrom.length(), nTo=sTo.length();
+	const T* pFrom=sFrom.data();
+	TBSS pos;
+	if(nFrom==0 || (pos=detail::str_find(sStr,pFrom,0,nFrom))==sStr.npos)
+		return 0;
+	size_t nCount=0;
+	if(nTo<=nFrom)
+	{
+		T* p=&sStr[0];
+		TBSS nWrite=pos, nRead=pos;
+		while(pos!=sStr.npos)
+		{
+			if(nWrite!=nRead)
+				std::copy(p+nRead,p+pos,p+nWrite);
+			nWrite+=pos-nRead;
+			std::copy(sTo.begin(),sTo.end(),p+nWrite);
+			nWrite+=nTo;
+			nRead=pos+nFrom;
+			nCount++;
+			pos=detail::str_find(sStr,pFrom,nRead,nFrom);
+		}
+		std::copy(p+nRead,p+sStr.length(),p+nWrite);
+		sStr.resize(nWrite+sStr.length()-nRead);
+		return nCount;
+	}
+	for(TBSS cur=pos;cur!=sStr.npos;cur=detail::str_find(sStr,pFrom,cur+nFrom,nFrom))
+		nCount++;
+	std::basic_string<T,Tr,A> sOut(sStr.get_allocator());
+	sOut.reserve(sStr.length()+nCount*(nTo-nFrom));
+	TBSS nRead=0;
+	for(;pos!=sStr.npos;pos=detail::str_find(sStr,pFrom,nRead,nFrom))
+	{
+		sOut.append(sStr,nRead,pos-nRead);
+		sOut.append(sTo.data(),nTo);
+		nRead=pos+nFrom;
+	}
+	sOut.append(sStr,nRead,sStr.npos);
+	sStr.swap(sOut);
+	return nCount;
+}
+
+template<class T>
+inline size_t replace_all_once(std::basic_string<T>& sStr, const std::basic_string<T>& sFrom, const std::basic_string<T>& sTo)
+{
+	return replace_all_once(sStr,basic_str_view<T>(sFrom),basic_str_view<T>(sTo));
+}
+
+inline size_t replace_all_once(std::string& sStr, str_view sFrom, str_view sTo) { return replace_all_once<char>(sStr,sFrom,sTo); }
+
+// Compiled dictionary of from->to replacements applied in one pass by Aho-Corasick automaton.
+// At every position the leftmost match is replaced, the longest one if several matches start there,
+// the replaced text is not searched again. Build it once and reuse for many strings.
+// The automaton is kept built, so replace doesn't change the object and may be called by several threads
+class multi_replacer
+{
+public:
+	multi_replacer() : pairs(), cls(), nClasses(1), next(), depth(), match() { compile(); }
+	explicit multi_replacer(const std::map<std::string,std::string>& dict) :
+		pairs(dict.begin(),dict.end()), cls(), nClasses(1), next(), depth(), match() { compile(); }
+	explicit multi_replacer(const std::vector<std::pair<std::string,std::string> >& dict) :
+		pairs(dict), cls(), nClasses(1), next(), depth(), match() { compile(); }
+
+	// Add the replacement, the first one of equal patterns is used. Empty patterns are ignored.
+	// The automaton is rebuilt, pass big dictionaries to the constructor
+	void add(const std::string& sFrom, const std::string& sTo)
+	{
+		pairs.push_back(std::make_pair(sFrom,sTo));
+		compile();
+	}
+
+	bool empty() const { return pairs.empty(); }
+	size_t size() const { return pairs.size(); }
+
+	// Write sIn with the replacements into sOut, returns the number of replacements
+	template<class A>
+	size_t replace(str_view sIn, std::basic_string<char,std::char_traits<char>,A>& sOut) const
+	{
+		sOut.clear();
+		sOut.reserve(sIn.length());
+		const char* s=sIn.data();
+		const size_t n=sIn.length();
+		size_t nCount=0, nCopied=0, i=0;
+		size_t nCandBeg=0, nCandLen=0;
+		int st=0, nCand=-1;
+		for(;;)
+		{
+			if(i<n)
+			{
+				st=next[st*nClasses+cls[(unsigned char)s[i++]]];
+				int m=match[st];
+				if(m>=0)
+				{
+					size_t len=pairs[m].first.length(), beg=i-len;
+					if(nCand<0 || beg<nCandBeg || (beg==nCandBeg && len>nCandLen))
+					{
+						nCand=m;
+						nCandBeg=beg;
+						nCandLen=len;
+					}
+				}
+				if(nCand<0 || i-depth[st]<=nCandBeg)	// a match starting not later may still follow
+					continue;
+			}
+			else if(nCand<0)
+				break;
+			sOut.append(s+nCopied,s+nCandBeg);
+			sOut.append(pairs[nCand].second.data(),pairs[nCand].second.length());
+			nCount++;
+			nCopied=i=nCandBeg+nCandLen;	// scanning restarts after the replaced text
+			st=0;
+			nCand=-1;
+		}
+		sOut.append(s+nCopied,s+n);
+		return nCount;
+	}
+
+	// Replace in place, returns the number of replacements
+	template<class A>
+	size_t replace(std::basic_string<char,std::char_traits<char>,A>& sStr) const
+	{
+		std::basic_string<char,std::char_traits<char>,A> sOut(sStr.get_allocator());
+		size_t nCount=replace(sStr,sOut);
+		if(nCount)
+			sStr.swap(sOut);
+		return nCount;
+	}
+
+protected:
+	// Build the automaton of the dictionary
+	void compile()
+	{
+		clear_classes();
+		nClasses=1;	// class 0 - bytes absent from the patterns
+		for(size_t p=0;p<pairs.size();p++)
+			for(size_t i=0;i<pairs[p].first.length();i++)
+			{
+				unsigned char c=(unsigned char)pairs[p].first[i];
+				if(cls[c]==0)
+					cls[c]=(unsigned short)nClasses++;
+			}
+
+		next.assign(nClasses,-1);
+		depth.assign(1,0);
+		match.assign(1,-1);
+		for(size_t p=0;p<pairs.size();p++)	// trie of the patterns
+		{
+			const std::string& sFrom=pairs[p].first;
+			if(sFrom.empty())
+				continue;
+			int st=0;
+			for(size_t i=0;i<sFrom.length();i++)
+			{
+				int& to=next[st*nClasses+cls[(unsigned char)sFrom[i]]];
+				if(to<0)
+				{
+					to=(int)depth.size();
+					next.resize(next.size()+nClasses,-1);
+					depth.push_back((int)i+1);
+					match.push_back(-1);
+				}
+				st=next[st*nClasses+cls[(unsigned char)sFrom[i]]];
+			}
+			if(match[st]<0)
+				match[st]=(int)p;
+		}
+
+		std::vector<int> fail(depth.size(),0), queue;	// breadth first completion of the transitions
+		queue.reserve(depth.size());
+		for(int c=0;c<nClasses;c++)
+		{
+			int& to=next[c];
+			if(to<0)
+				to=0;
+			else
+				queue.push_back(to);
+		}
+		for(size_t q=0;q<queue.size();q++)
+		{
+			int st=queue[q];
+			if(match[st]<0)
+				match[st]=match[fail[st]];	// longest pattern which is a suffix
+			for(int c=0;c<nClasses;c++)
+			{
+				int& to=next[st*nClasses+c];
+				if(to<0)
+					to=next[fail[st]*nClasses+c];
+				else
+				{
+					fail[to]=next[fail[st]*nClasses+c];
+					queue.push_back(to);
+				}
+			}
+		}
+	}
+
+	void clear_classes()
+	{
+		for(int c=0;c<256;c++)
+			cls[c]=0;
+	}
+
+	std::vector<std::pair<std::string,std::string> > pairs;
+	unsigned short cls[256];	// byte classes: bytes of the patterns get their own classes
+	int nClasses;
+	std::vector<int> next;		// transitions state*nClasses+class -> state
+	std::vector<int> depth;		// length of the state prefix
+	std::vector<int> match;		// the longest pattern ending at the state or -1
+};
+
+// Apply the compiled dictionary, returns the number of replacements
+inline size_t replace_many(std::string& sStr, const multi_replacer& dict)
+{
+	return dict.replace(sStr);
+}
+
+inline size_t replace_many(std::string& sStr, const std::map<std::string,std::string>& dict)
+{
+	return multi_replacer(dict).replace(sStr);
+}
+
+// Replaces sFrom at the end of the string, nothing is done if the string doesn't end by it or sFrom is empty
+template<class T, class Tr, class A>
+inline void replace_from_end(std::basic_string<T,Tr,A>& sStr, const basic_str_view<T>& sFrom, const basic_str_view<T>& sTo)
+{
+	if(!sFrom.empty() && ends_with(basic_str_view<T>(sStr),sFrom))
+		sStr.replace(sStr.length()-sFrom.length(),sFrom.length(),sTo.data(),sTo.length());
+}
+
 template<class T>
 inline void replace_from_end(std::basic_string<T>& sStr, const std::basic_string<T>& sFrom, const std::basic_string<T>& sTo)
 {
-	typename std::basic_string<T>::size_type pos=0;
-	if((pos=sStr.find(sFrom))==sStr.length()-sFrom.length() && pos!=sStr.npos)
-		sStr.replace(sStr.begin()+pos,sStr.begin()+pos+sFrom.length(),sTo.begin(),sTo.end());
+	replace_from_end(sStr,basic_str_view<T>(sFrom),basic_str_view<T>(sTo));
 }
 
+inline void replace_from_end(std::string& sStr, str_view sFrom, str_view sTo) { replace_from_end<char>(sStr,sFrom,sTo); }
+
 // Replaces the sequences of chars from sDelims to the given sTo string
 // Example: replace_delimeters("rabbit","bijk","--") "rabbit" -> "ra--t"
-template<class T>
-inline void replace_delimeters(std::basic_string<T>& sStr, const std::basic_string<T>& sDelims, const std::basic_string<T>& sTo)
+template<class T, class Tr, class A>
+inline void replace_delimeters(std::basic_string<T,Tr,A>& sStr, const basic_str_view<T>& sDelims, const basic_str_view<T>& sTo)
 {
-  using namespace std;
 	if(sStr.length()==0)
 		return;
-	STL_TYPENAME_EX(std::vector<basic_string<T> >,TVec);
-	std::string sOut;
-	TVec vecParts;
-	split(vecParts,sStr,sDelims);
+	typedef basic_split_range<T> TRange;
+	std::basic_string<T,Tr,A> sOut(sStr.get_allocator());
 	if(sDelims.find(sStr[0])!=sDelims.npos)	// prefix
-		sOut+=sTo;
-	for(TVec_i it=vecParts.begin();it!=vecParts.end();it++)
+		sOut.append(sTo.data(),sTo.length());
+	TRange range(basic_str_view<T>(sStr),sDelims);
+	for(typename TRange::iterator it=range.begin();it!=range.end();++it)
 	{
-		sOut+=*it;
-		if(it!=vecParts.end()-1)
-			sOut+=sTo;
+		if(it!=range.begin())
+			sOut.append(sTo.data(),sTo.length());
+		sOut.append(it->data(),it->length());
 	}
 	if(sDelims.find(sStr[sStr.length()-1])!=sDelims.npos)	// postfix
-		sOut+=sTo;
-	sStr=sOut;
+		sOut.append(sTo.data(),sTo.length());
+	sStr.swap(sOut);
+}
+
+template<class T>
+inline void replace_delimeters(std::basic_string<T>& sStr, const std::basic_string<T>& sDelims, const std::basic_string<T>& sTo)
+{
+	replace_delimeters(sStr,basic_str_view<T>(sDelims),basic_str_view<T>(sTo));
 }
 
 template<class T>
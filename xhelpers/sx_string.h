@@ -8,71 +8,130 @@
 #define SX_STRING_H
 
 #include <xhelpers/sx_str.h>
+#include <xhelpers/sx_format.h>
+#include <xhelpers/sx_matchtemplate.h>
+#include <xhelpers/sx_utf8case.h>
+#include <xhelpers/sx_arena.h>
 
 #include <string>
 #include <vector>
 
 namespace sx {
 
-class tf_string : public std::string
+// String with the extended functions of sx_str.h as methods. CharT and the allocator are those of the
+// base std::basic_string, the new strings (split, join, replacements) take the allocator of this string.
+// The methods working with charset, charmap, UTF-8 case and formats are defined for char strings only
+template <class CharT, class Alloc = std::allocator<CharT> >
+class basic_tf_string : public std::basic_string<CharT, std::char_traits<CharT>, Alloc>
 {
 public:
-    tf_string(const char* p="") { std::string::operator=(p); }
-    tf_string(char* p) { std::string::operator=(p); }
-    tf_string(std::string s) { std::string::operator=(s); }
-    virtual ~tf_string() { ; }
-    tf_string& replace(const char* from, const char* to)
+    typedef std::basic_string<CharT, std::char_traits<CharT>, Alloc> base_string;
+    typedef sx::basic_str_view<CharT> view_type;
+    typedef Alloc allocator_type;
+
+    basic_tf_string() : base_string() {}
+    basic_tf_string(const CharT* p) : base_string(p) {}
+    basic_tf_string(CharT* p) : base_string(p) {}
+    basic_tf_string(const base_string& s) : base_string(s) {}
+    explicit basic_tf_string(const Alloc& a) : base_string(a) {}
+    basic_tf_string(const CharT* p, const Alloc& a) : base_string(p, a) {}
+    basic_tf_string(view_type s, const Alloc& a) : base_string(s.data(), s.size(), a) {}
+    virtual ~basic_tf_string() { ; }
+
+    // Replaces all occurrences of from in one pass, the inserted text is not searched again
+    basic_tf_string& replace(const CharT* from, const CharT* to)
+    {
+        sx::replace_all_once(*this,view_type(from),view_type(to));
+        return *this;
+    }
+
+    // Applies all replacements of the compiled dictionary in one pass
+    basic_tf_string& replace_many(const sx::multi_replacer& dict)
     {
-        sx::replace_all(*this,std::string(from),std::string(to));
+        dict.replace(*this);
         return *this;
     }
 
-    tf_string& lreplace(const char* from, const char* to)
+    basic_tf_string& lreplace(const CharT* from, const CharT* to)
     {
-        using namespace std;
-        sx::replace_first(*this,std::string(from),std::string(to));
+        sx::replace_first(*this,view_type(from),view_type(to));
         return *this;
     }
     
-    tf_string& rreplace(const char* from, const char* to)
+    basic_tf_string& rreplace(const CharT* from, const CharT* to)
     {   
-        sx::replace_from_end(*this,std::string(from),std::string(to));
+        sx::replace_from_end(*this,view_type(from),view_type(to));
+        return *this;
+    }
+
+    basic_tf_string& erase_sym(const char* symbols)
+    {
+        sx::erase_sym(*this,sx::charset(symbols));
+        return *this;
+    }
+
+    basic_tf_string& erase_sym(const sx::charset& symbols)
+    {
+        sx::erase_sym(*this,symbols);
+        return *this;
+    }
+
+    basic_tf_string& erase_sym_left(const char* symbols)
+    {
+        sx::erase_sym_left(*this,sx::charset(symbols));
+        return *this;
+    }
+
+    basic_tf_string& erase_sym_left(const sx::charset& symbols)
+    {
+        sx::erase_sym_left(*this,symbols);
         return *this;
     }
 
-    tf_string& erase_sym(const char* symbols)
+    basic_tf_string& erase_sym_right(const char* symbols)
     {
-        sx::erase_sym(*this,std::string(symbols));
+        sx::erase_sym_right(*this,sx::charset(symbols));
         return *this;
     }
 
-    tf_string& erase_sym_left(const char* symbols)
+    basic_tf_string& erase_sym_right(const sx::charset& symbols)
     {
-        sx::erase_sym_left(*this,std::string(symbols));
+        sx::erase_sym_right(*this,symbols);
         return *this;
     }
 
-    tf_string& erase_sym_right(const char* symbols)
+    basic_tf_string& change_sym(const CharT* from, const CharT* to)
     {
-        sx::erase_sym_right(*this,std::string(symbols));
+        sx::change_sym(*this,sx::charmap(from,to));
         return *this;
     }
 
-    tf_string& change_sym(const char* from, const char* to)
+    basic_tf_string& change_sym(const sx::charmap& map)
     {
-        sx::change_sym(*this,std::string(from),std::string(to));
+        sx::change_sym(*this,map);
         return *this;
     }
 
-    tf_string& change_sym_right(const char* from, const char* to)
+    basic_tf_string& change_sym_right(const CharT* from, const CharT* to)
     {
-        sx::change_sym_right(*this,std::string(from),std::string(to));
+        sx::change_sym_right(*this,sx::charmap(from,to));
+        return *this;
+    }
+
+    basic_tf_string& change_sym_right(const sx::charmap& map)
+    {
+        sx::change_sym_right(*this,map);
         return *this;
     }
 
     bool symbol_exist(const char* symbols)
     {
-        return sx::symbol_exist(*this,std::string(symbols));
+        return sx::symbol_exist(sx::str_view(*this),sx::charset(symbols));
+    }
+
+    bool symbol_exist(const sx::charset& symbols)
+    {
+        return sx::symbol_exist(sx::str_view(*this),symbols);
     }
 
     bool is_consonant(char c)
@@ -80,46 +139,64 @@ public:
         return sx::is_consonant(c);
     }
 
-    inline tf_string& lower()
+    // Case conversion of UTF-8 text, the length is kept
+    inline basic_tf_string& lower()
     {
-        sx::lower(*this);
+        sx::utf8_lower(*this);
         return *this;
     }
 
-    inline tf_string& upper()
+    inline basic_tf_string& upper()
     {
-        sx::upper(*this);
+        sx::utf8_upper(*this);
         return *this;
     }
     
-    bool begins_with(const char* prefix)
+    bool begins_with(const CharT* prefix)
     {
-        return sx::begins_with(*this,std::string(prefix));
+        return sx::begins_with(view_type(*this),view_type(prefix));
     }
 
-    bool ends_with(const char* postfix)
+    bool ends_with(const CharT* postfix)
     {
-        return sx::ends_with(*this,std::string(postfix));
+        return sx::ends_with(view_type(*this),view_type(postfix));
     }
 
     bool consist_of(const char* symbols)
     {
-        return sx::consist_of(this->c_str(),symbols);
+        return sx::consist_of(sx::str_view(*this),symbols);
     }
 
-    int split(std::vector<std::string>& vsVec,const char* delimeters)
+    // Tokens are the strings with the allocator of this string
+    int split(std::vector<base_string>& vsVec,const CharT* delimeters)
     {
-        return sx::split(vsVec,*this,std::string(delimeters));
+        typedef sx::basic_split_range<CharT> TRange;
+        vsVec.clear();
+        TRange range(view_type(*this),view_type(delimeters));
+        for(typename TRange::iterator it=range.begin();it!=range.end();++it)
+            vsVec.push_back(base_string(it->data(),it->length(),this->get_allocator()));
+        return (int)vsVec.size();
     }
 
-    std::vector<std::string> split(const char* delimeters)
+    // Views are valid while the string is alive and unchanged
+    int split(std::vector<view_type>& vsVec,const CharT* delimeters) const
     {
-        using namespace std;
-        vector<string> vsVec;
-        sx::split(vsVec,*this,string(delimeters));
+        return sx::split(vsVec,view_type(*this),view_type(delimeters));
+    }
+
+    std::vector<base_string> split(const CharT* delimeters)
+    {
+        std::vector<base_string> vsVec;
+        split(vsVec,delimeters);
         return vsVec;
     }
 
+    // Lazy split without allocations, see sx::split_view
+    sx::basic_split_range<CharT> split_view(const CharT* delimeters) const
+    {
+        return sx::split_view(view_type(*this),view_type(delimeters));
+    }
+
     // Joins a vector of strings sVec into vsStr using *this as delimiter
     // similar to python str join method. Also has convinient alias.
     // example code
@@ -128,74 +205,66 @@ public:
     // tf_string(", ").join(res, vector<string>{"abc", "bca", "aaa"})
     //
     // in both cases, res would have value "abc, bca, aaa";
-    int join(std::string &vsStr, const std::vector<std::string> &sVec)
+    int join(base_string &vsStr, const std::vector<base_string> &sVec)
     {
-      return sx::join(vsStr, sVec, *this);
+      return sx::join(vsStr, sVec, static_cast<const base_string&>(*this));
     }
 
-    std::string join(const std::vector<std::string> &sVec)
+    base_string join(const std::vector<base_string> &sVec)
     {
-      std::string vsStr;
-      sx::join(vsStr, sVec, *this);
+      base_string vsStr(this->get_allocator());
+      sx::join(vsStr, sVec, static_cast<const base_string&>(*this));
       return vsStr;
     }
 
     // Replaces the sequences of chars from sDelims to the given sTo string
     // Example: replace_delimeters("rabbit","bijk","--") "rabbit" -> "ra--t"
-    tf_string& replace_delimeters(const char* delimeters=" .,\"\':;", const char* replace_by=" ")
+    basic_tf_string& replace_delimeters(const char* delimeters=" .,\"\':;", const char* replace_by=" ")
     {
-        sx::replace_delimeters(*this,std::string(delimeters),std::string(replace_by));
+        sx::replace_delimeters(*this,sx::str_view(delimeters),sx::str_view(replace_by));
         return *this;
     }
 
     // Returns true if string matches template $-letter #-digit *-any symbol
     bool match_template(const char* _templ)
     {
-        using namespace std;
-        tf_string templ(_templ);
-        if(templ.length()!=this->length())
-            return false;
-        for(tf_string::iterator i = templ.begin(); i!=templ.end(); i++)
-        {
-            char& c = (*this)[i-templ.begin()];
-            if(*i==c)
-                continue;
-            switch(*i)
-            {
-            case '#':
-                if(is_digit(c))
-                    continue;
-                return false;
-            case '$':
-                if(is_letter(c))
-                    continue;
-                return false;
-            case '*':
-                continue;
-            default:
-                return false;
-            }
-        }
-        
-        return true;
+        return sx::match_template(sx::str_view(*this),sx::str_view(_templ));
+    }
+
+    // The same for the template compiled once, see sx::compiled_template
+    bool match_template(const sx::compiled_template& templ) const
+    {
+        return templ.match(*this);
     }
   
-    // sprintf parameters
-    tf_string&  format(const char* _templ, ... )
+    // printf-like formatting by sx::format: the output is not truncated, the arguments are type-safe
+    template <class... Args>
+    basic_tf_string&  format(const char* _templ, const Args&... args)
     {
-        char buff[4096]; buff[0]=0;
-        va_list list;
-        va_start(list, _templ );
-        vsprintf(buff, _templ, list );
-        va_end( list );
-        (*this) = buff;
+        base_string s(this->get_allocator());
+        sx::format_to(s,_templ,args...);
+        this->swap(s);
         return *this;
     }
 
 };
 
+// The char string, a class rather than a typedef so that it can be forward declared as before
+class tf_string : public basic_tf_string<char>
+{
+public:
+    tf_string(const char* p="") : basic_tf_string<char>(p) {}
+    tf_string(char* p) : basic_tf_string<char>(p) {}
+    tf_string(const std::string& s) : basic_tf_string<char>(s) {}
+    virtual ~tf_string() { ; }
+};
+
 typedef tf_string xstring;
 
+// String in a monotonic arena: sx::arena_string s("text", sx::arena_allocator<char>(arena)).
+// The default constructed one uses the heap
+typedef basic_tf_string<char, arena_allocator<char> > arena_string;
+
 }; // namespace sx
 
 #endif // SX_STRING_H
@@ -0,0 +1,182 @@
+//!
+//!@file    xhelpers/sx_stringpool.h
+//!@author  Sholomov Dmitry
+//!@date    17.10.2026
+//!@brief   Pool of interned strings shared by threads: equal strings are stored once and get stable 4-byte ids
+//!
+
+#ifndef SX_STRINGPOOL_H
+#define SX_STRINGPOOL_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <functional>
+
+#include <xhelpers/sx_str.h>
+
+namespace sx {
+
+class string_pool;
+
+namespace detail {
+
+//! Pooled chars are preceded by the id and the length
+struct pooled_header
+{
+  unsigned id;
+  unsigned len;
+};
+
+struct pooled_empty_record
+{
+  pooled_header hdr;
+  char chars[8];
+};
+
+//! Record of the empty string, common for all pools with id 0
+inline const char* pooled_empty()
+{
+  static const pooled_empty_record rec = { { 0, 0 }, { 0 } };
+  return rec.chars;
+}
+
+} // namespace detail
+
+//! @class pooled_string xhelpers/sx_stringpool.h
+//! @brief Handle of a string interned in a string_pool, the pointer to the pooled zero-terminated chars.
+//!        Equal strings of a pool have equal handles, so comparison and hashing are pointer operations.
+//!        The handle is valid while the pool is alive. The default handle is the empty string
+class pooled_string
+{
+public:
+  pooled_string() : p(detail::pooled_empty()) {}
+
+  const char* c_str() const { return p; }
+  const char* data() const { return p; }
+  size_t size() const { return header()->len; }
+  size_t length() const { return header()->len; }
+  bool empty() const { return header()->len == 0; }
+  unsigned id() const { return header()->id; }          //!< Id in the pool, 0 for the empty string
+
+  str_view view() const { return str_view(p, header()->len); }
+  operator str_view() const { return view(); }
+  std::string str() const { return std::string(p, header()->len); }
+
+  //! Identity of the strings of the same pool. The order is the pointer order, not lexicographical
+  bool operator==(const pooled_string& s) const { return p == s.p; }
+  bool operator!=(const pooled_string& s) const { return p != s.p; }
+  bool operator<(const pooled_string& s) const { return std::less<const char*>()(p, s.p); }
+
+protected:
+  friend class string_pool;
+  explicit pooled_string(const char* _p) : p(_p) {}
+  const detail::pooled_header* header() const { return reinterpret_cast<const detail::pooled_header*>(p) - 1; }
+
+  const char* p;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const pooled_string& s)
+{
+  return os.write(s.data(), s.size());
+}
+
+//! @class string_pool xhelpers/sx_stringpool.h
+//! @brief Set of interned strings. intern() returns the same handle for equal strings, ids are dense:
+//!        0 for the empty string, then 1, 2, ... in the order of the first interning, so arrays may be indexed by them.
+//!        The strings are kept until the pool is destroyed.
+//!        intern() and find() are thread-safe, the set is split into shards by hash with a lock per shard,
+//!        so threads interning different strings rarely wait. at() and str() by id take no locks
+class string_pool
+{
+public:
+  typedef unsigned int id_type;
+  static const id_type no_id = 0xFFFFFFFFu;
+
+  string_pool();
+  virtual ~string_pool();
+
+  //! Handle of the pooled copy of s, the string is added on the first call
+  pooled_string intern(str_view s);
+  id_type intern_id(str_view s) { return intern(s).id(); }
+
+  //! Handle of the pooled s if it was interned
+  bool find(str_view s, pooled_string& ps) const;
+
+  //! String by id, the id must be from this pool
+  pooled_string at(id_type id) const
+  {
+    const entry* blk = dir.load(std::memory_order_acquire)[id >> block_bits].load(std::memory_order_acquire);
+    return pooled_string(blk[id & (block_size - 1)]);
+  }
+  str_view str(id_type id) const { return at(id).view(); }
+
+  size_t size() const { return nNext.load(); }          //!< Number of ids given, including the empty string
+  size_t memory() const;                                //!< Bytes of the strings and the tables
+
+private:
+  string_pool(const string_pool &);                     //!< Конструктор копирования (запрещен)
+  string_pool &operator=(const string_pool &);          //!< Оператор присваивания (запрещен)
+
+  typedef const char* entry;                            //!< Chars of the string with the id
+  static const unsigned shard_bits = 4;
+  static const unsigned nShards = 1 << shard_bits;
+  static const unsigned block_bits = 12;                //!< Ids per block of the id directory: 4096
+  static const size_t block_size = (size_t)1 << block_bits;
+  static const size_t chunk_size = 1 << 16;             //!< Chars are stored in chunks of 64K
+
+  struct slot
+  {
+    const char* p;                                      //!< NULL for the free slot
+    unsigned hash;
+  };
+
+  struct shard
+  {
+    std::mutex mtx;
+    std::vector<slot> slots;                            //!< Open addressing table, the size is a power of 2
+    size_t nCount;
+    std::vector<char*> chunks;
+    size_t nChunkUsed;                                  //!< Bytes used in the last chunk
+    size_t nBytes;
+    shard() : mtx(), slots(), nCount(0), chunks(), nChunkUsed(chunk_size), nBytes(0) {}
+  };
+
+  static sx_uint64 hash(str_view s);
+  static const char* lookup(const shard& sh, str_view s, sx_uint64 h, size_t& pos);
+  char* alloc(shard& sh, size_t n);
+  void set_entry(id_type id, const char* p);
+
+  mutable shard shards[nShards];
+  std::atomic<id_type> nNext;
+  mutable std::mutex mtxDir;                            //!< Guards growth of the directory
+  std::atomic<std::atomic<entry*>*> dir;                //!< Blocks of ids, replaced by a bigger copy on growth
+  size_t nDirSize;
+  std::atomic<size_t> nBlocks;                          //!< Blocks allocated, 0..nBlocks-1
+  std::vector<std::atomic<entry*>*> dirs;               //!< Current and replaced directories, freed with the pool
+};
+
+//! split with the tokens interned in the pool: repeated values share one copy
+inline int split(std::vector<pooled_string>& vsVec, str_view sStr, str_view sSep, string_pool& pool)
+{
+  vsVec.clear();
+  split_range range(sStr, sSep);
+  for (split_range::iterator it = range.begin(); it != range.end(); ++it)
+    vsVec.push_back(pool.intern(*it));
+  return (int)vsVec.size();
+}
+
+} // namespace sx
+
+namespace std {
+
+template <>
+struct hash<sx::pooled_string>
+{
+  size_t operator()(const sx::pooled_string& s) const { return std::hash<const char*>()(s.c_str()); }
+};
+
+} // namespace std
+
+#endif // SX_STRINGPOOL_H
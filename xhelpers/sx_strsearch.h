@@ -0,0 +1,334 @@
+//!
+//!@file    xhelpers/sx_strsearch.h
+//!@author  Sholomov Dmitry
+//!@date    17.10.2026
+//!@brief   Substring search by AVX2 first/last byte filtering with the two-way algorithm fallback for long needles
+//!@note    Define SX_NO_SIMD to build the scalar implementation only
+//!
+
+#ifndef SX_STRSEARCH_H
+#define SX_STRSEARCH_H
+
+#include <cstring>
+#include <cstddef>
+
+#include <xhelpers/sx_delimscan.h>
+
+namespace sx {
+
+namespace detail {
+
+//! Longer needles are searched by the two-way algorithm if the byte filter gives too many false candidates:
+//! verifying every candidate by memcmp is quadratic on periodic texts
+const size_t search_long_needle = 64;
+
+//! Index of the highest set bit, m must be non-zero
+inline int highest_bit(sx_uint64 m)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+  unsigned long idx; _BitScanReverse64(&idx, m); return (int)idx;
+#elif defined(_MSC_VER)
+  unsigned long idx;
+  if (m >> 32) { _BitScanReverse(&idx, (unsigned long)(m >> 32)); return (int)idx + 32; }
+  _BitScanReverse(&idx, (unsigned long)m); return (int)idx;
+#else
+  return 63 - __builtin_clzll(m);
+#endif
+}
+
+//! Bytes of the sequence read forward or backward, the backward search is the forward one on reversed sequences
+template <bool Rev>
+struct search_seq
+{
+  const unsigned char* p;
+  size_t n;
+  search_seq(const char* _p, size_t _n) : p(reinterpret_cast<const unsigned char*>(_p)), n(_n) {}
+  unsigned char operator[](size_t i) const { return Rev ? p[n - 1 - i] : p[i]; }
+};
+
+//! Critical factorization of the needle for the two-way algorithm: returns the split position, period of the right part
+template <class Seq>
+size_t critical_factorization(const Seq& s, size_t n, size_t& period)
+{
+  size_t ms = (size_t)-1, j = 0, k = 1, p = 1;        // maximal suffix by the byte order
+  while (j + k < n)
+  {
+    unsigned char a = s[j + k], b = s[ms + k];
+    if (a < b) { j += k; k = 1; p = j - ms; }
+    else if (a == b) { if (k != p) k++; else { j += p; k = 1; } }
+    else { ms = j++; k = p = 1; }
+  }
+  period = p;
+  size_t msr = (size_t)-1;                            // maximal suffix by the reversed byte order
+  j = 0; k = p = 1;
+  while (j + k < n)
+  {
+    unsigned char a = s[j + k], b = s[msr + k];
+    if (b < a) { j += k; k = 1; p = j - msr; }
+    else if (a == b) { if (k != p) k++; else { j += p; k = 1; } }
+    else { msr = j++; k = p = 1; }
+  }
+  if (msr + 1 < ms + 1)
+    return ms + 1;
+  period = p;
+  return msr + 1;
+}
+
+//! Two-way search (Crochemore-Perrin) of s[0,n) in h[0,hn), linear time and constant memory. 0 < n <= hn
+template <class Seq>
+size_t two_way_find(const Seq& h, size_t hn, const Seq& s, size_t n)
+{
+  size_t period;
+  const size_t suffix = critical_factorization(s, n, period);
+  bool periodic = true;
+  for (size_t i = 0; i < suffix && periodic; i++)
+    periodic = s[i] == s[i + period];
+  if (periodic)
+  {
+    size_t memory = 0;                                // prefix of the needle known to match after a period shift
+    for (size_t j = 0; j <= hn - n; )
+    {
+      size_t i = suffix > memory ? suffix : memory;
+      while (i < n && s[i] == h[i + j])
+        i++;
+      if (i < n)
+      {
+        j += i - suffix + 1;
+        memory = 0;
+        continue;
+      }
+      i = suffix - 1;
+      while (memory < i + 1 && s[i] == h[i + j])
+        i--;
+      if (i + 1 < memory + 1)
+        return j;
+      j += period;
+      memory = n - period;
+    }
+  }
+  else
+  {
+    period = (suffix > n - suffix ? suffix : n - suffix) + 1;
+    for (size_t j = 0; j <= hn - n; )
+    {
+      size_t i = suffix;
+      while (i < n && s[i] == h[i + j])
+        i++;
+      if (i < n)
+      {
+        j += i - suffix + 1;
+        continue;
+      }
+      i = suffix - 1;
+      while (i != (size_t)-1 && s[i] == h[i + j])
+        i--;
+      if (i == (size_t)-1)
+        return j;
+      j += period;
+    }
+  }
+  return (size_t)-1;
+}
+
+//! Result of the filtering kernels if too many candidates were rejected, the search goes on by the two-way algorithm
+const size_t search_gave_up = (size_t)-2;
+
+//! Number of candidates which may be verified before the position i: unlimited for short needles,
+//! for long ones the verification work is kept linear in the scanned length
+inline bool search_budget_ok(size_t nChecked, size_t i, size_t n)
+{
+  return n <= search_long_needle || nChecked <= 16 + 4 * i / n;
+}
+
+//! Candidate filtering by the first and the last bytes of the needle. Positions are checked from 0 up, stop is the
+//! first unchecked position if the kernel gave up. 2 <= n <= hn
+inline size_t find_filter_scalar(const char* h, size_t hn, const char* s, size_t n, size_t& stop)
+{
+  const char* last = h + hn - n;
+  size_t nChecked = 0;
+  for (const char* p = h; p <= last; p++)
+  {
+    p = static_cast<const char*>(memchr(p, s[0], last - p + 1));
+    if (!p)
+      break;
+    if (p[n - 1] == s[n - 1])
+    {
+      if (memcmp(p + 1, s + 1, n - 2) == 0)
+        return p - h;
+      if (!search_budget_ok(++nChecked, p - h, n))
+      {
+        stop = p - h + 1;
+        return search_gave_up;
+      }
+    }
+  }
+  return (size_t)-1;
+}
+
+//! The same from the last position down, stop is the number of unchecked positions if the kernel gave up
+inline size_t rfind_filter_scalar(const char* h, size_t hn, const char* s, size_t n, size_t& stop)
+{
+  size_t nChecked = 0;
+  for (size_t i = hn - n + 1; i-- > 0; )
+    if (h[i] == s[0] && h[i + n - 1] == s[n - 1])
+    {
+      if (memcmp(h + i + 1, s + 1, n - 2) == 0)
+        return i;
+      if (!search_budget_ok(++nChecked, hn - n - i, n))
+      {
+        stop = i;
+        return search_gave_up;
+      }
+    }
+  return (size_t)-1;
+}
+
+#ifdef SX_SIMD_X86
+
+//! Bit mask of the positions p..p+31 where the first and the last bytes of the needle match
+SX_TARGET("avx2")
+inline unsigned search_mask_avx2(const char* p, size_t n, __m256i first, __m256i last)
+{
+  __m256i bf = _mm256_loadu_si256((const __m256i*)p);
+  __m256i bl = _mm256_loadu_si256((const __m256i*)(p + n - 1));
+  return (unsigned)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(bf, first), _mm256_cmpeq_epi8(bl, last)));
+}
+
+//! 64 positions are filtered at once, only the candidates are compared
+SX_TARGET("avx2")
+inline size_t find_filter_avx2(const char* h, size_t hn, const char* s, size_t n, size_t& stop)
+{
+  const __m256i first = _mm256_set1_epi8(s[0]);
+  const __m256i last = _mm256_set1_epi8(s[n - 1]);
+  size_t i = 0, nChecked = 0;
+  for (; i + n - 1 + 64 <= hn; i += 64)
+  {
+    sx_uint64 m = search_mask_avx2(h + i, n, first, last) | (sx_uint64)search_mask_avx2(h + i + 32, n, first, last) << 32;
+    for (; m; m &= m - 1)
+    {
+      size_t c = i + lowest_bit(m);
+      if (memcmp(h + c + 1, s + 1, n - 2) == 0)
+        return c;
+      if (!search_budget_ok(++nChecked, c, n))
+      {
+        stop = c + 1;
+        return search_gave_up;
+      }
+    }
+  }
+  size_t pos = find_filter_scalar(h + i, hn - i, s, n, stop);
+  if (pos == search_gave_up)
+    stop += i;
+  return pos == (size_t)-1 || pos == search_gave_up ? pos : i + pos;
+}
+
+SX_TARGET("avx2")
+inline size_t rfind_filter_avx2(const char* h, size_t hn, const char* s, size_t n, size_t& stop)
+{
+  const __m256i first = _mm256_set1_epi8(s[0]);
+  const __m256i last = _mm256_set1_epi8(s[n - 1]);
+  size_t i = hn - n + 1, nChecked = 0;               // positions [0,i) are not checked yet
+  for (; i >= 64; i -= 64)
+  {
+    sx_uint64 m = search_mask_avx2(h + i - 64, n, first, last) | (sx_uint64)search_mask_avx2(h + i - 32, n, first, last) << 32;
+    for (; m; m &= ~((sx_uint64)1 << highest_bit(m)))
+    {
+      size_t c = i - 64 + highest_bit(m);
+      if (memcmp(h + c + 1, s + 1, n - 2) == 0)
+        return c;
+      if (!search_budget_ok(++nChecked, hn - n - c, n))
+      {
+        stop = c;
+        return search_gave_up;
+      }
+    }
+  }
+  return rfind_filter_scalar(h, i + n - 1, s, n, stop);
+}
+
+#endif // SX_SIMD_X86
+
+typedef size_t (*search_fn)(const char* h, size_t hn, const char* s, size_t n, size_t& stop);
+
+struct search_kernel
+{
+  search_fn find;
+  search_fn rfind;
+};
+
+// Kernel is chosen once on the first use by the CPU features
+inline const search_kernel& select_search_kernel()
+{
+  static const search_kernel scalar = { find_filter_scalar, rfind_filter_scalar };
+#ifdef SX_SIMD_X86
+  static const search_kernel avx2 = { find_filter_avx2, rfind_filter_avx2 };
+  static const search_kernel& selected = cpu_has_avx2() ? avx2 : scalar;
+  return selected;
+#else
+  return scalar;
+#endif
+}
+
+} // namespace detail
+
+//! Position of the first occurrence of s[0,n) in h[0,hn) starting from pos or npos (size_t(-1)),
+//! the same result as std::string::find
+inline size_t find(const char* h, size_t hn, const char* s, size_t n, size_t pos = 0)
+{
+  if (pos > hn || n > hn - pos)
+    return (size_t)-1;
+  if (n == 0)
+    return pos;
+  h += pos; hn -= pos;
+  if (n == 1)
+  {
+    const void* p = memchr(h, s[0], hn);
+    return p ? static_cast<const char*>(p) - h + pos : (size_t)-1;
+  }
+  size_t stop = 0;
+  size_t res = detail::select_search_kernel().find(h, hn, s, n, stop);
+  if (res == detail::search_gave_up)
+  {
+    if (n > hn - stop)
+      return (size_t)-1;
+    res = detail::two_way_find(detail::search_seq<false>(h + stop, hn - stop), hn - stop, detail::search_seq<false>(s, n), n);
+    if (res != (size_t)-1)
+      res += stop;
+  }
+  return res == (size_t)-1 ? res : res + pos;
+}
+
+//! Position of the last occurrence of s[0,n) in h[0,hn) starting not after pos or npos (size_t(-1)),
+//! the same result as std::string::rfind
+inline size_t rfind(const char* h, size_t hn, const char* s, size_t n, size_t pos = (size_t)-1)
+{
+  if (n > hn)
+    return (size_t)-1;
+  if (pos < hn - n)
+    hn = pos + n;                                     // occurrences must start at or before pos
+  if (n == 0)
+    return hn;
+  if (n == 1)
+  {
+    for (size_t i = hn; i-- > 0; )
+      if (h[i] == s[0])
+        return i;
+    return (size_t)-1;
+  }
+  size_t stop = 0;
+  size_t res = detail::select_search_kernel().rfind(h, hn, s, n, stop);
+  if (res == detail::search_gave_up)
+  {
+    hn = stop + n - 1;                                // positions [0,stop) are left
+    if (n > hn)
+      return (size_t)-1;
+    res = detail::two_way_find(detail::search_seq<true>(h, hn), hn, detail::search_seq<true>(s, n), n);
+    if (res != (size_t)-1)
+      res = hn - n - res;
+  }
+  return res;
+}
+
+} // namespace sx
+
+#endif // SX_STRSEARCH_H
@@ -0,0 +1,140 @@
+//!
+//!@file    xhelpers/sx_strview.h
+//!@author  Sholomov Dmitry
+//!@date    17.10.2026
+//!@brief   Non-owning view of a character sequence (lightweight std::string_view analog for C++11 builds)
+//!
+
+#ifndef SX_STRVIEW_H
+#define SX_STRVIEW_H
+
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include <ostream>
+
+namespace sx {
+
+//! @class basic_str_view xhelpers/sx_strview.h
+//! @brief Pointer and length of a character sequence owned by someone else.
+//!        The view is valid while the owning buffer (string, file mapping etc.) is alive and unchanged
+template <class T>
+class basic_str_view
+{
+public:
+  typedef T                                       value_type;
+  typedef const T*                                iterator;
+  typedef const T*                                const_iterator;
+  typedef size_t                                  size_type;
+  typedef std::char_traits<T>                     traits_type;
+
+  static const size_type npos = static_cast<size_type>(-1);
+
+  basic_str_view() : ptr(0), len(0) {}                                //!< Empty view
+  basic_str_view(const T* p) :                                        //!< View of zero-terminated string
+    ptr(p), len(p ? traits_type::length(p) : 0) {}
+  basic_str_view(const T* p, size_type n) : ptr(p), len(n) {}         //!< View of n chars starting from p
+  basic_str_view(const T* b, const T* e) : ptr(b), len(e-b) {}        //!< View of [b,e) range
+  template <class Tr, class A>
+  basic_str_view(const std::basic_string<T,Tr,A>& s) :                //!< View of std::string contents
+    ptr(s.data()), len(s.length()) {}
+
+  const T* data() const           { return ptr; }
+  size_type size() const          { return len; }
+  size_type length() const        { return len; }
+  bool empty() const              { return len==0; }
+  const_iterator begin() const    { return ptr; }
+  const_iterator end() const      { return ptr+len; }
+  const T& operator[](size_type i) const { return ptr[i]; }
+  const T& front() const          { return ptr[0]; }
+  const T& back() const           { return ptr[len-1]; }
+
+  void remove_prefix(size_type n) { ptr+=n; len-=n; }
+  void remove_suffix(size_type n) { len-=n; }
+
+  //! Subview [pos, pos+n), n is truncated by the view length
+  basic_str_view substr(size_type pos, size_type n = npos) const
+  {
+    if(pos>len)
+      pos=len;
+    return basic_str_view(ptr+pos, std::min(n, len-pos));
+  }
+
+  //! Lexicographical comparison, the same result sign as std::string::compare
+  int compare(const basic_str_view& s) const
+  {
+    int res = traits_type::compare(ptr, s.ptr, std::min(len, s.len));
+    if(res!=0)
+      return res;
+    return len<s.len ? -1 : (len>s.len ? 1 : 0);
+  }
+
+  //! Position of the first occurrence of c starting from pos or npos
+  size_type find(T c, size_type pos = 0) const
+  {
+    for(size_type i=pos; i<len; i++)
+      if(traits_type::eq(ptr[i],c))
+        return i;
+    return npos;
+  }
+
+  //! Position of the first occurrence of s starting from pos or npos, empty s is found at pos
+  size_type find(const basic_str_view& s, size_type pos = 0) const
+  {
+    if(pos>len || s.len>len-pos)
+      return npos;
+    const T* p = std::search(ptr+pos, ptr+len, s.ptr, s.ptr+s.len);
+    return p==ptr+len && s.len>0 ? npos : p-ptr;
+  }
+
+  //! Position of the last occurrence of s or npos
+  size_type rfind(const basic_str_view& s) const
+  {
+    if(s.len>len)
+      return npos;
+    for(size_type i=len-s.len+1; i-->0; )
+      if(traits_type::compare(ptr+i, s.ptr, s.len)==0)
+        return i;
+    return npos;
+  }
+
+  std::basic_string<T> str() const { return std::basic_string<T>(ptr, len); }  //!< Owning copy
+
+protected:
+  const T*  ptr;
+  size_type len;
+};
+
+template <class T>
+const typename basic_str_view<T>::size_type basic_str_view<T>::npos;
+
+template <class T>
+inline bool operator==(const basic_str_view<T>& a, const basic_str_view<T>& b)
+{
+  return a.size()==b.size() && a.compare(b)==0;
+}
+
+template <class T>
+inline bool operator!=(const basic_str_view<T>& a, const basic_str_view<T>& b)
+{
+  return !(a==b);
+}
+
+template <class T>
+inline bool operator<(const basic_str_view<T>& a, const basic_str_view<T>& b)
+{
+  return a.compare(b)<0;
+}
+
+template <class T>
+inline std::basic_ostream<T>& operator<<(std::basic_ostream<T>& os, const basic_str_view<T>& s)
+{
+  return os.write(s.data(), s.size());
+}
+
+typedef basic_str_view<char>    str_view;
+typedef basic_str_view<wchar_t> wstr_view;
+
+} // namespace sx
+
+#endif // SX_STRVIEW_H
@@ -104,7 +104,8 @@ inline double xtimer::getDuration(bool bUpdate)
 //!< Текстовое представление времени между замерами
 inline const char* xtimer::getDurationText(const char* format, bool bUpdate)
 {
-  message = sx::xstring().format(format ? format : "%2.2fms", getDuration(bUpdate));
+  message.clear();
+  sx::format_to(message, format ? format : "%2.2fms", getDuration(bUpdate));
   return message.c_str();
 }
 
@@ -0,0 +1,261 @@
+//!
+//!@file    xhelpers/sx_typedreader.h
+//!@author  Sholomov Dmitry
+//!@date    17.10.2026
+//!@brief   Reading delimited data into typed columns by a column schema
+//!
+
+#ifndef SX_TYPEDREADER_H
+#define SX_TYPEDREADER_H
+
+#include <vector>
+#include <string>
+#include <istream>
+
+#include <xhelpers/sx_cast.h>
+#include <xhelpers/sx_srm.h>
+
+namespace sx {
+
+//! Types of the typed_table columns
+enum column_type
+{
+  col_skip,                                             //!< Field is not stored
+  col_int32,                                            //!< int
+  col_int64,                                            //!< long long
+  col_double,                                           //!< double
+  col_string,                                           //!< std::string
+  col_timestamp                                         //!< long long nanoseconds since 1970-01-01T00:00:00Z
+};
+
+//! Parses "YYYY-MM-DD[THH:MM:SS[.fffffffff]][Z|+hh:mm|-hh:mm]" (' ' is allowed instead of 'T') into
+//! nanoseconds since 1970-01-01T00:00:00Z. Time without the zone suffix is taken as UTC
+inline bool parse_timestamp(const char* b, const char* e, long long& nsec)
+{
+  struct digits
+  {
+    static bool get(const char*& p, const char* e, int n, int& val)
+    {
+      if (e - p < n)
+        return false;
+      val = 0;
+      for (int i = 0; i < n; i++, p++)
+      {
+        if ((unsigned)(*p - '0') > 9)
+          return false;
+        val = val*10 + (*p - '0');
+      }
+      return true;
+    }
+  };
+
+  const char* p = b;
+  int year, mon, day, hour = 0, min = 0, sec = 0;
+  long frac = 0;
+  if (!digits::get(p, e, 4, year) || p == e || *p++ != '-' || !digits::get(p, e, 2, mon) ||
+      p == e || *p++ != '-' || !digits::get(p, e, 2, day))
+    return false;
+  if (mon < 1 || mon > 12 || day < 1 || day > 31)
+    return false;
+  if (p < e && (*p == 'T' || *p == ' '))
+  {
+    p++;
+    if (!digits::get(p, e, 2, hour) || p == e || *p++ != ':' || !digits::get(p, e, 2, min) ||
+        p == e || *p++ != ':' || !digits::get(p, e, 2, sec))
+      return false;
+    if (hour > 23 || min > 59 || sec > 60)
+      return false;
+    if (p < e && *p == '.')
+    {
+      int n = 0;
+      for (p++; p < e && (unsigned)(*p - '0') <= 9; p++, n++)
+        if (n < 9)
+          frac = frac*10 + (*p - '0');
+      if (n == 0)
+        return false;
+      for (; n < 9; n++)
+        frac *= 10;
+    }
+  }
+  long bias = 0;                                        // zone offset in seconds
+  if (p < e && *p == 'Z')
+    p++;
+  else if (p < e && (*p == '+' || *p == '-'))
+  {
+    int sign = *p++ == '-' ? -1 : 1, bh, bm;
+    if (!digits::get(p, e, 2, bh) || p == e || *p++ != ':' || !digits::get(p, e, 2, bm))
+      return false;
+    bias = sign * (bh*3600L + bm*60L);
+  }
+  if (p != e)
+    return false;
+
+  // days from civil, proleptic Gregorian calendar
+  int y = mon <= 2 ? year - 1 : year;
+  long era = (y >= 0 ? y : y - 399) / 400;
+  long yoe = y - era * 400;
+  long doy = (153 * (mon + (mon > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  long long days = era * 146097LL + doe - 719468;
+
+  nsec = ((days * 86400 + hour * 3600 + min * 60 + sec) - bias) * 1000000000LL + frac;
+  return true;
+}
+
+//! @class typed_table xhelpers/sx_typedreader.h
+//! @brief Table of typed columns filled from delimited text by a column schema.
+//!        Fields are parsed directly from the input bytes, the fields which can't be parsed
+//!        and the missing fields are stored as zero (empty string) and counted in bad_fields()
+class typed_table
+{
+public:
+  explicit typed_table(const std::vector<column_type>& _schema) :
+    schema(_schema), columns(_schema.size()), nRows(0), nBadFields(0) {}
+  virtual ~typed_table() {}
+
+  size_t rows() const { return nRows; }                 //!< Number of rows
+  size_t cols() const { return schema.size(); }         //!< Number of columns in the schema
+  column_type type(size_t col) const { return schema[col]; }
+  size_t bad_fields() const { return nBadFields; }      //!< Number of fields which were not parsed
+
+  // Column data, the column must be of the corresponding type
+  std::vector<int>& int32_col(size_t col) { return columns[col].i32; }
+  std::vector<long long>& int64_col(size_t col) { return columns[col].i64; }
+  std::vector<double>& double_col(size_t col) { return columns[col].f64; }
+  std::vector<std::string>& string_col(size_t col) { return columns[col].str; }
+  std::vector<long long>& timestamp_col(size_t col) { return columns[col].i64; }
+
+  const std::vector<int>& int32_col(size_t col) const { return columns[col].i32; }
+  const std::vector<long long>& int64_col(size_t col) const { return columns[col].i64; }
+  const std::vector<double>& double_col(size_t col) const { return columns[col].f64; }
+  const std::vector<std::string>& string_col(size_t col) const { return columns[col].str; }
+  const std::vector<long long>& timestamp_col(size_t col) const { return columns[col].i64; }
+
+  //! Reserve memory for the expected number of rows
+  void reserve(size_t nExpectedRows)
+  {
+    for (size_t c = 0; c < columns.size(); c++)
+      switch (schema[c])
+      {
+      case col_int32:     columns[c].i32.reserve(nExpectedRows); break;
+      case col_int64:
+      case col_timestamp: columns[c].i64.reserve(nExpectedRows); break;
+      case col_double:    columns[c].f64.reserve(nExpectedRows); break;
+      case col_string:    columns[c].str.reserve(nExpectedRows); break;
+      default: break;
+      }
+  }
+
+  //! Parses line [b,e) split by read_vec_string rules and appends its fields to the columns.
+  //! Fields beyond the schema are ignored
+  void add_line(const char* b, const char* e, const delim_set& delims, bool bDelimSingle = false)
+  {
+    field_parser parser(*this);
+    split_delim_line(b, e, delims, bDelimSingle, parser);
+    for (size_t c = parser.col; c < schema.size(); c++)
+      add_missing(c);
+    nRows++;
+  }
+
+protected:
+  struct column_data
+  {
+    std::vector<int>         i32;
+    std::vector<long long>   i64;
+    std::vector<double>      f64;
+    std::vector<std::string> str;
+    column_data() : i32(), i64(), f64(), str() {}
+  };
+
+  struct field_parser
+  {
+    typed_table& tbl;
+    size_t col;
+    explicit field_parser(typed_table& _tbl) : tbl(_tbl), col(0) {}
+    void operator()(const char* b, const char* e)
+    {
+      if (col < tbl.schema.size())
+        tbl.add_field(col, b, e);
+      col++;
+    }
+  };
+
+  void add_field(size_t col, const char* b, const char* e)
+  {
+    column_data& c = columns[col];
+    bool ok = true;
+    switch (schema[col])
+    {
+    case col_int32:     c.i32.push_back(0); ok = parse_int(b, e, c.i32.back()); break;
+    case col_int64:     c.i64.push_back(0); ok = parse_int(b, e, c.i64.back()); break;
+    case col_double:    c.f64.push_back(0); ok = parse_double(b, e, c.f64.back()); break;
+    case col_timestamp: c.i64.push_back(0); ok = parse_timestamp(b, e, c.i64.back()); break;
+    case col_string:    c.str.push_back(std::string(b, e)); break;
+    default: break;
+    }
+    if (!ok)
+      nBadFields++;
+  }
+
+  void add_missing(size_t col)
+  {
+    column_data& c = columns[col];
+    switch (schema[col])
+    {
+    case col_int32:     c.i32.push_back(0); break;
+    case col_int64:
+    case col_timestamp: c.i64.push_back(0); break;
+    case col_double:    c.f64.push_back(0); break;
+    case col_string:    c.str.push_back(std::string()); break;
+    default: return;
+    }
+    nBadFields++;
+  }
+
+  std::vector<column_type> schema;
+  std::vector<column_data> columns;
+  size_t nRows;
+  size_t nBadFields;
+};
+
+//! Reads all rows of the stream into the typed table, the line buffer is reused between rows
+inline std::istream& read_typed(std::istream& is, typed_table& tbl, const char* delim = "\t\n\r ", char delim_line = '\n', bool bDelimSingle = false)
+{
+  delim_set delims(delim);
+  std::string str_line;
+  while (getline(is, str_line, delim_line))
+  {
+    const char* strbuf = str_line.c_str();
+    tbl.add_line(strbuf, strbuf + strlen(strbuf), delims, bDelimSingle);
+  }
+  return is;
+}
+
+//! Reads the memory mapped file into the typed table. Returns false if the file can't be opened
+inline bool read_typed(const char* filename, typed_table& tbl, const char* delim = "\t\n\r ", char delim_line = '\n', bool bDelimSingle = false)
+{
+  mapped_file file(filename);
+  if (!file.is_open())
+    return false;
+  delim_set delims(delim);
+  const char* cur = file.data();
+  const char* end = cur + file.size();
+  while (cur < end)
+  {
+    const char* line_end = static_cast<const char*>(memchr(cur, delim_line, end - cur));
+    if (!line_end)
+      line_end = end;
+    tbl.add_line(cur, line_end, delims, bDelimSingle);
+    cur = line_end + 1;
+  }
+  return true;
+}
+
+inline bool read_typed(const std::string& filename, typed_table& tbl, const char* delim = "\t\n\r ", char delim_line = '\n', bool bDelimSingle = false)
+{
+  return read_typed(filename.c_str(), tbl, delim, delim_line, bDelimSingle);
+}
+
+} // namespace sx
+
+#endif // SX_TYPEDREADER_H
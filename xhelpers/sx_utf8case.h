@@ -0,0 +1,208 @@
+//!
+//!@file    xhelpers/sx_utf8case.h
+//!@author  Sholomov Dmitry
+//!@date    17.10.2026
+//!@brief   Lower and upper case conversion of UTF-8 strings with AVX2 processing of ASCII blocks
+//!@note    Define SX_NO_SIMD to build the scalar implementation only
+//!
+
+#ifndef SX_UTF8CASE_H
+#define SX_UTF8CASE_H
+
+#include <string>
+
+#include <xhelpers/sx_delimscan.h>
+
+namespace sx {
+
+namespace detail {
+
+struct utf8_case_range
+{
+  unsigned short first, last;                           //!< Code points range
+  short delta;                                          //!< Offset of the mapped code point
+  unsigned char step;                                   //!< 1 - every code point, 2 - every other one
+};
+
+//! Case maps of the two-byte code points U+0080..U+07FF (Latin-1, Latin Extended, Greek, Cyrillic, Armenian).
+//! Only the mappings to two-byte code points are included, so conversion never changes the string length
+struct utf8_case_tables
+{
+  unsigned short lower[0x800];
+  unsigned short upper[0x800];
+
+  utf8_case_tables() : lower(), upper()
+  {
+    static const utf8_case_range utf8_lower_ranges[] = {
+      { 0x00C0, 0x00D6, 32, 1 }, { 0x00D8, 0x00DE, 32, 1 }, { 0x0100, 0x012E, 1, 2 }, { 0x0132, 0x0136, 1, 2 },
+      { 0x0139, 0x0147, 1, 2 }, { 0x014A, 0x0176, 1, 2 }, { 0x0178, 0x0178, -121, 1 }, { 0x0179, 0x017D, 1, 2 },
+      { 0x0181, 0x0181, 210, 1 }, { 0x0182, 0x0184, 1, 2 }, { 0x0186, 0x0186, 206, 1 }, { 0x0187, 0x0187, 1, 1 },
+      { 0x0189, 0x018A, 205, 1 }, { 0x018B, 0x018B, 1, 1 }, { 0x018E, 0x018E, 79, 1 }, { 0x018F, 0x018F, 202, 1 },
+      { 0x0190, 0x0190, 203, 1 }, { 0x0191, 0x0191, 1, 1 }, { 0x0193, 0x0193, 205, 1 }, { 0x0194, 0x0194, 207, 1 },
+      { 0x0196, 0x0196, 211, 1 }, { 0x0197, 0x0197, 209, 1 }, { 0x0198, 0x0198, 1, 1 }, { 0x019C, 0x019C, 211, 1 },
+      { 0x019D, 0x019D, 213, 1 }, { 0x019F, 0x019F, 214, 1 }, { 0x01A0, 0x01A4, 1, 2 }, { 0x01A6, 0x01A6, 218, 1 },
+      { 0x01A7, 0x01A7, 1, 1 }, { 0x01A9, 0x01A9, 218, 1 }, { 0x01AC, 0x01AC, 1, 1 }, { 0x01AE, 0x01AE, 218, 1 },
+      { 0x01AF, 0x01AF, 1, 1 }, { 0x01B1, 0x01B2, 217, 1 }, { 0x01B3, 0x01B5, 1, 2 }, { 0x01B7, 0x01B7, 219, 1 },
+      { 0x01B8, 0x01B8, 1, 1 }, { 0x01BC, 0x01BC, 1, 1 }, { 0x01C4, 0x01C4, 2, 1 }, { 0x01C5, 0x01C5, 1, 1 },
+      { 0x01C7, 0x01C7, 2, 1 }, { 0x01C8, 0x01C8, 1, 1 }, { 0x01CA, 0x01CA, 2, 1 }, { 0x01CB, 0x01DB, 1, 2 },
+      { 0x01DE, 0x01EE, 1, 2 }, { 0x01F1, 0x01F1, 2, 1 }, { 0x01F2, 0x01F4, 1, 2 }, { 0x01F6, 0x01F6, -97, 1 },
+      { 0x01F7, 0x01F7, -56, 1 }, { 0x01F8, 0x021E, 1, 2 }, { 0x0220, 0x0220, -130, 1 }, { 0x0222, 0x0232, 1, 2 },
+      { 0x023B, 0x023B, 1, 1 }, { 0x023D, 0x023D, -163, 1 }, { 0x0241, 0x0241, 1, 1 }, { 0x0243, 0x0243, -195, 1 },
+      { 0x0244, 0x0244, 69, 1 }, { 0x0245, 0x0245, 71, 1 }, { 0x0246, 0x024E, 1, 2 }, { 0x0370, 0x0372, 1, 2 },
+      { 0x0376, 0x0376, 1, 1 }, { 0x037F, 0x037F, 116, 1 }, { 0x0386, 0x0386, 38, 1 }, { 0x0388, 0x038A, 37, 1 },
+      { 0x038C, 0x038C, 64, 1 }, { 0x038E, 0x038F, 63, 1 }, { 0x0391, 0x03A1, 32, 1 }, { 0x03A3, 0x03AB, 32, 1 },
+      { 0x03CF, 0x03CF, 8, 1 }, { 0x03D8, 0x03EE, 1, 2 }, { 0x03F4, 0x03F4, -60, 1 }, { 0x03F7, 0x03F7, 1, 1 },
+      { 0x03F9, 0x03F9, -7, 1 }, { 0x03FA, 0x03FA, 1, 1 }, { 0x03FD, 0x03FF, -130, 1 }, { 0x0400, 0x040F, 80, 1 },
+      { 0x0410, 0x042F, 32, 1 }, { 0x0460, 0x0480, 1, 2 }, { 0x048A, 0x04BE, 1, 2 }, { 0x04C0, 0x04C0, 15, 1 },
+      { 0x04C1, 0x04CD, 1, 2 }, { 0x04D0, 0x052E, 1, 2 }, { 0x0531, 0x0556, 48, 1 },
+    };
+    static const utf8_case_range utf8_upper_ranges[] = {
+      { 0x00B5, 0x00B5, 743, 1 }, { 0x00E0, 0x00F6, -32, 1 }, { 0x00F8, 0x00FE, -32, 1 }, { 0x00FF, 0x00FF, 121, 1 },
+      { 0x0101, 0x012F, -1, 2 }, { 0x0133, 0x0137, -1, 2 }, { 0x013A, 0x0148, -1, 2 }, { 0x014B, 0x0177, -1, 2 },
+      { 0x017A, 0x017E, -1, 2 }, { 0x0180, 0x0180, 195, 1 }, { 0x0183, 0x0185, -1, 2 }, { 0x0188, 0x0188, -1, 1 },
+      { 0x018C, 0x018C, -1, 1 }, { 0x0192, 0x0192, -1, 1 }, { 0x0195, 0x0195, 97, 1 }, { 0x0199, 0x0199, -1, 1 },
+      { 0x019A, 0x019A, 163, 1 }, { 0x019E, 0x019E, 130, 1 }, { 0x01A1, 0x01A5, -1, 2 }, { 0x01A8, 0x01A8, -1, 1 },
+      { 0x01AD, 0x01AD, -1, 1 }, { 0x01B0, 0x01B0, -1, 1 }, { 0x01B4, 0x01B6, -1, 2 }, { 0x01B9, 0x01B9, -1, 1 },
+      { 0x01BD, 0x01BD, -1, 1 }, { 0x01BF, 0x01BF, 56, 1 }, { 0x01C5, 0x01C5, -1, 1 }, { 0x01C6, 0x01C6, -2, 1 },
+      { 0x01C8, 0x01C8, -1, 1 }, { 0x01C9, 0x01C9, -2, 1 }, { 0x01CB, 0x01CB, -1, 1 }, { 0x01CC, 0x01CC, -2, 1 },
+      { 0x01CE, 0x01DC, -1, 2 }, { 0x01DD, 0x01DD, -79, 1 }, { 0x01DF, 0x01EF, -1, 2 }, { 0x01F2, 0x01F2, -1, 1 },
+      { 0x01F3, 0x01F3, -2, 1 }, { 0x01F5, 0x01F5, -1, 1 }, { 0x01F9, 0x021F, -1, 2 }, { 0x0223, 0x0233, -1, 2 },
+      { 0x023C, 0x023C, -1, 1 }, { 0x0242, 0x0242, -1, 1 }, { 0x0247, 0x024F, -1, 2 }, { 0x0253, 0x0253, -210, 1 },
+      { 0x0254, 0x0254, -206, 1 }, { 0x0256, 0x0257, -205, 1 }, { 0x0259, 0x0259, -202, 1 },
+      { 0x025B, 0x025B, -203, 1 }, { 0x0260, 0x0260, -205, 1 }, { 0x0263, 0x0263, -207, 1 },
+      { 0x0268, 0x0268, -209, 1 }, { 0x0269, 0x0269, -211, 1 }, { 0x026F, 0x026F, -211, 1 },
+      { 0x0272, 0x0272, -213, 1 }, { 0x0275, 0x0275, -214, 1 }, { 0x0280, 0x0280, -218, 1 },
+      { 0x0283, 0x0283, -218, 1 }, { 0x0288, 0x0288, -218, 1 }, { 0x0289, 0x0289, -69, 1 }, { 0x028A, 0x028B, -217, 1 },
+      { 0x028C, 0x028C, -71, 1 }, { 0x0292, 0x0292, -219, 1 }, { 0x0345, 0x0345, 84, 1 }, { 0x0371, 0x0373, -1, 2 },
+      { 0x0377, 0x0377, -1, 1 }, { 0x037B, 0x037D, 130, 1 }, { 0x03AC, 0x03AC, -38, 1 }, { 0x03AD, 0x03AF, -37, 1 },
+      { 0x03B1, 0x03C1, -32, 1 }, { 0x03C2, 0x03C2, -31, 1 }, { 0x03C3, 0x03CB, -32, 1 }, { 0x03CC, 0x03CC, -64, 1 },
+      { 0x03CD, 0x03CE, -63, 1 }, { 0x03D0, 0x03D0, -62, 1 }, { 0x03D1, 0x03D1, -57, 1 }, { 0x03D5, 0x03D5, -47, 1 },
+      { 0x03D6, 0x03D6, -54, 1 }, { 0x03D7, 0x03D7, -8, 1 }, { 0x03D9, 0x03EF, -1, 2 }, { 0x03F0, 0x03F0, -86, 1 },
+      { 0x03F1, 0x03F1, -80, 1 }, { 0x03F2, 0x03F2, 7, 1 }, { 0x03F3, 0x03F3, -116, 1 }, { 0x03F5, 0x03F5, -96, 1 },
+      { 0x03F8, 0x03F8, -1, 1 }, { 0x03FB, 0x03FB, -1, 1 }, { 0x0430, 0x044F, -32, 1 }, { 0x0450, 0x045F, -80, 1 },
+      { 0x0461, 0x0481, -1, 2 }, { 0x048B, 0x04BF, -1, 2 }, { 0x04C2, 0x04CE, -1, 2 }, { 0x04CF, 0x04CF, -15, 1 },
+      { 0x04D1, 0x052F, -1, 2 }, { 0x0561, 0x0586, -48, 1 },
+    };
+    for (unsigned cp = 0; cp < 0x800; cp++)
+      lower[cp] = upper[cp] = (unsigned short)cp;
+    fill(lower, utf8_lower_ranges, sizeof(utf8_lower_ranges) / sizeof(utf8_lower_ranges[0]));
+    fill(upper, utf8_upper_ranges, sizeof(utf8_upper_ranges) / sizeof(utf8_upper_ranges[0]));
+  }
+
+  static void fill(unsigned short* tab, const utf8_case_range* ranges, size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+      for (unsigned cp = ranges[i].first; cp <= ranges[i].last; cp += ranges[i].step)
+        tab[cp] = (unsigned short)(cp + ranges[i].delta);
+  }
+};
+
+inline const utf8_case_tables& get_utf8_case_tables()
+{
+  static const utf8_case_tables tables;
+  return tables;
+}
+
+// Converts the chars starting in [p,stop), sequences may end up to end. ASCII letters from first to first+25
+// get 0x20 bit flipped, two-byte sequences are translated by tab, other bytes are kept. Returns the next char
+inline char* utf8_case_scalar(char* p, char* stop, char* end, const unsigned short* tab, char first)
+{
+  while (p < stop)
+  {
+    unsigned char c = (unsigned char)*p;
+    if (c < 0x80)
+    {
+      if ((unsigned char)(c - first) < 26)
+        *p = (char)(c ^ 0x20);
+      p++;
+    }
+    else if (c >= 0xC2 && c < 0xE0 && p + 1 < end && ((unsigned char)p[1] & 0xC0) == 0x80)
+    {
+      unsigned cp = ((c & 0x1F) << 6) | ((unsigned char)p[1] & 0x3F);
+      unsigned m = tab[cp];
+      if (m != cp)
+      {
+        p[0] = (char)(0xC0 | (m >> 6));
+        p[1] = (char)(0x80 | (m & 0x3F));
+      }
+      p += 2;
+    }
+    else
+      p++;
+  }
+  return p;
+}
+
+inline void utf8_case_plain(char* p, char* end, const unsigned short* tab, char first)
+{
+  utf8_case_scalar(p, end, end, tab, first);
+}
+
+#ifdef SX_SIMD_X86
+
+SX_TARGET("avx2")
+inline void utf8_case_avx2(char* p, char* end, const unsigned short* tab, char first)
+{
+  const __m256i lo = _mm256_set1_epi8((char)(first - 1));
+  const __m256i hi = _mm256_set1_epi8((char)(first + 26));
+  const __m256i flip = _mm256_set1_epi8(0x20);
+  while (end - p >= 32)
+  {
+    __m256i blk = _mm256_loadu_si256((const __m256i*)p);
+    if (_mm256_movemask_epi8(blk) == 0)                 // ASCII block
+    {
+      __m256i letters = _mm256_and_si256(_mm256_cmpgt_epi8(blk, lo), _mm256_cmpgt_epi8(hi, blk));
+      _mm256_storeu_si256((__m256i*)p, _mm256_xor_si256(blk, _mm256_and_si256(letters, flip)));
+      p += 32;
+    }
+    else
+      p = utf8_case_scalar(p, p + 32, end, tab, first);
+  }
+  utf8_case_scalar(p, end, end, tab, first);
+}
+
+#endif // SX_SIMD_X86
+
+typedef void (*utf8_case_fn)(char* p, char* end, const unsigned short* tab, char first);
+
+inline utf8_case_fn select_utf8_case_kernel()
+{
+#ifdef SX_SIMD_X86
+  static const utf8_case_fn selected = cpu_has_avx2() ? utf8_case_avx2 : utf8_case_plain;
+  return selected;
+#else
+  return utf8_case_plain;
+#endif
+}
+
+} // namespace detail
+
+//! Lower case of the UTF-8 chars of [b,e) in place: ASCII and two-byte letters, other chars are kept
+inline void utf8_lower(char* b, char* e)
+{
+  detail::select_utf8_case_kernel()(b, e, detail::get_utf8_case_tables().lower, 'A');
+}
+
+//! Upper case of the UTF-8 chars of [b,e) in place: ASCII and two-byte letters, other chars are kept
+inline void utf8_upper(char* b, char* e)
+{
+  detail::select_utf8_case_kernel()(b, e, detail::get_utf8_case_tables().upper, 'a');
+}
+
+template <class A>
+inline void utf8_lower(std::basic_string<char, std::char_traits<char>, A>& str)
+{
+  if (!str.empty())
+    utf8_lower(&str[0], &str[0] + str.length());
+}
+
+template <class A>
+inline void utf8_upper(std::basic_string<char, std::char_traits<char>, A>& str)
+{
+  if (!str.empty())
+    utf8_upper(&str[0], &str[0] + str.length());
+}
+
+} // namespace sx
+
+#endif // SX_UTF8CASE_H